@@ -7,12 +7,19 @@
 #include "OSInterface/OSWindowMonitor.h"
 #include "WindowManager.h"
 #include "utility/PlatformInitializer.h"
+#include "utility/TimingStats.h"
 #include "utility/Utilities.h"
+#include "Leap/GL/Projection.h"
+#include "Leap/GL/Shader.h"
+#include "Leap/GL/StateCache.h"
+#include "Leap/GL/UniformBufferRing.h"
 
 #if _WIN32
 #include "Mirror.h"
 #endif
 
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <stdexcept>
 
@@ -21,8 +28,17 @@ int main(int argc, char **argv)
   PlatformInitializer init;
   AutoCurrentContext ctxt;
 
+  ARScreenOptions options;
+  if (!options.Parse(argc, argv)) {
+    std::cout << "Usage: " << argv[0] << " [--record <file> [--record-images]] [--replay <file> [--realtime]]"
+              << " [--headless [--size <width>x<height>]] [--frames <n>] [--step <seconds>]"
+              << " [--predict <seconds>|auto] [--coalesce <n>] [--validate-gl-state] [--validate-intersections]" << std::endl;
+    return 1;
+  }
+
   ctxt->Initiate();
   AutoRequired<ARScreen> arScreen;
+  arScreen->SetOptions(options);
 
   try {
     // Handoff to the main loop:
@@ -43,7 +59,57 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, INT)
 }
 #endif
 
-ARScreen::ARScreen(void)
+bool ARScreenOptions::Parse(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg(argv[i]);
+    if (arg == "--record" && i + 1 < argc) {
+      recordPath = argv[++i];
+    } else if (arg == "--record-images") {
+      recordImages = true;
+    } else if (arg == "--replay" && i + 1 < argc) {
+      replayPath = argv[++i];
+    } else if (arg == "--realtime") {
+      replayRealTime = true;
+    } else if (arg == "--headless") {
+      headless = true;
+    } else if (arg == "--size" && i + 1 < argc) {
+      if (std::sscanf(argv[++i], "%dx%d", &headlessWidth, &headlessHeight) != 2 || headlessWidth <= 0 || headlessHeight <= 0) {
+        return false;
+      }
+    } else if (arg == "--frames" && i + 1 < argc) {
+      frameCount = std::atoi(argv[++i]);
+    } else if (arg == "--step" && i + 1 < argc) {
+      fixedStep = std::atof(argv[++i]);
+    } else if (arg == "--predict" && i + 1 < argc) {
+      const std::string value(argv[++i]);
+      if (value == "auto") {
+        predictionHorizon = -1.0;
+      } else {
+        predictionHorizon = std::atof(value.c_str());
+        if (predictionHorizon < 0.0) {
+          return false;
+        }
+      }
+    } else if (arg == "--coalesce" && i + 1 < argc) {
+      maxFramesPerUpdate = std::atoi(argv[++i]);
+    } else if (arg == "--validate-gl-state") {
+      validateGLState = true;
+    } else if (arg == "--validate-intersections") {
+      validateIntersections = true;
+    } else {
+      return false;
+    }
+  }
+  if (headless && fixedStep <= 0.0) {
+    // a headless run should be reproducible, so default to the DK2's refresh rate
+    fixedStep = 1.0 / 75.0;
+  }
+  return frameCount >= 0 && fixedStep >= 0.0 && maxFramesPerUpdate >= 0;
+}
+
+ARScreen::ARScreen(void) :
+  m_Listener(FRAME_RING_CAPACITY),
+  m_LatencySampleTimestamp(0)
 {
 }
 
@@ -54,27 +120,37 @@ void ARScreen::Main(void) {
   arScreenCtxt->Initiate();
   CurrentContextPusher pshr(arScreenCtxt);
 
-  WindowParams params;
-  params.antialias = true;
-  params.vsync = false;
-  params.fullscreen = true;
-  m_Window.Init(params);
-  if (glewInit() != GLEW_OK) {
-    throw std::runtime_error("Unable to initialize glew");
+  if (m_Options.headless) {
+    m_Offscreen.Init(m_Options.headlessWidth, m_Options.headlessHeight);
+  } else {
+    WindowParams params;
+    params.antialias = true;
+    params.vsync = false;
+    params.fullscreen = true;
+    m_Window.Init(params);
+    if (glewInit() != GLEW_OK) {
+      throw std::runtime_error("Unable to initialize glew");
+    }
   }
   FreeImage_Initialise();
 
   // these should be created after GL context creation
   AutoRequired<WindowManager>();
   AutoRequired<OSVirtualScreen>();
-  AutoRequired<OSWindowMonitor>()->EnableScan(true);
+  AutoRequired<OSWindowMonitor>()->EnableScan(!m_Options.headless);
   AutoRequired<AudioVolumeInterface>();
   AutoRequired<MediaInterface>();
 
-  m_Oculus.SetWindow(static_cast<OculusVR::WindowHandle>(m_Window.GetWindowHandle()));
-  if (!m_Oculus.Init()) {
+  bool oculusInitialized = false;
+  if (!m_Options.headless) {
+    m_Oculus.SetWindow(static_cast<OculusVR::WindowHandle>(m_Window.GetWindowHandle()));
+    oculusInitialized = m_Oculus.Init();
+  }
+  if (!oculusInitialized) {
     Globals::haveOculus = false;
-    std::cout << "No Oculus detected" << std::endl;
+    if (!m_Options.headless) {
+      std::cout << "No Oculus detected" << std::endl;
+    }
     m_ShowMirror = false;
   } else {
     Globals::haveOculus = true;
@@ -86,29 +162,112 @@ void ARScreen::Main(void) {
   }
 
   m_Scene.Init();
-  m_Controller.addListener(m_Listener);
+  m_Latency = LatencyMonitor(m_Options.predictionHorizon);
+  m_Scene.SetMaxFramesPerUpdate(static_cast<size_t>(m_Options.maxFramesPerUpdate));
+  m_Scene.SetValidateIntersections(m_Options.validateIntersections);
+  if (!m_Options.replayPath.empty()) {
+    const FrameReplaySource::Pacing pacing = m_Options.replayRealTime ? FrameReplaySource::Pacing::REAL_TIME : FrameReplaySource::Pacing::FULL_SPEED;
+    m_Replay = std::shared_ptr<FrameReplaySource>(new FrameReplaySource(m_Options.replayPath, pacing));
+    m_Scene.SetReplaySource(m_Replay);
+  } else if (!m_Options.headless) {
+    // a headless run only takes tracking data from a replay, so that it is reproducible
+    m_Controller.addListener(m_Listener);
+  }
+  if (!m_Options.recordPath.empty()) {
+    m_Recorder = std::shared_ptr<FrameRecorder>(new FrameRecorder(m_Options.recordPath, m_Options.recordImages));
+  }
 
   InitMirror();
 
+  const std::chrono::steady_clock::duration fixedStep = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(m_Options.fixedStep));
+  TimingStats updateStats("update");
+  TimingStats renderStats("render");
+  TimingStats frameStats("frame");
+
+  // Only count the uniform uploads and GL state changes of the frames themselves
+  Leap::GL::Shader::UploadStats() = Leap::GL::Shader::UniformUploadStats();
+  Leap::GL::StateCache& stateCache = Leap::GL::StateCache::Current();
+  stateCache.SetValidationEnabled(m_Options.validateGLState);
+  stateCache.Stats() = Leap::GL::StateCache::CallStats();
+
   // Dispatch events until told to quit:
   Globals::prevFrameTime = std::chrono::steady_clock::now();
-  for(AutoCurrentContext ctxt; !ctxt->IsShutdown(); ) {
+  int frameIdx = 0;
+  for(AutoCurrentContext ctxt; !ctxt->IsShutdown() && !(m_Replay && m_Replay->Finished()); frameIdx++) {
+    if (m_Options.frameCount > 0 && frameIdx >= m_Options.frameCount) {
+      break;
+    }
+
     // Handle autowiring events:
     DispatchAllEvents();
 
     // Handle SFML events
-    HandleWindowEvents();
+    if (!m_Options.headless) {
+      HandleWindowEvents();
+    }
 
-    Globals::curFrameTime = std::chrono::steady_clock::now();
+    // With a fixed step, the clock is simulated so that runs are reproducible
+    if (m_Options.fixedStep > 0.0) {
+      Globals::curFrameTime = Globals::prevFrameTime + fixedStep;
+    } else {
+      Globals::curFrameTime = std::chrono::steady_clock::now();
+    }
     Globals::timeBetweenFrames = Globals::curFrameTime - Globals::prevFrameTime;
     Globals::elapsedTimeSeconds += Globals::timeBetweenFrames.count();
 
+    // SFML and the Oculus SDK change GL bindings behind the cache's back, and Update
+    // already binds textures and buffers through it
+    stateCache.Invalidate();
+
     // Main operations
+    const std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
     Update();
-    Render();
+    const std::chrono::steady_clock::time_point renderStart = std::chrono::steady_clock::now();
+    Leap::GL::UniformBufferRing::Shared().BeginFrame();
+    if (m_Options.headless) {
+      RenderHeadless();
+    } else {
+      Render();
+    }
+    const std::chrono::steady_clock::time_point renderEnd = std::chrono::steady_clock::now();
+    updateStats.AddSample(std::chrono::duration<double>(renderStart - updateStart).count());
+    renderStats.AddSample(std::chrono::duration<double>(renderEnd - renderStart).count());
+    frameStats.AddSample(std::chrono::duration<double>(renderEnd - updateStart).count());
+
+    // Latency is measured on the device's clock, so only against live frames,
+    // and once per frame, when it is first displayed
+    if (!m_Replay && m_Controller.isConnected()) {
+      const int64_t sampleTimestamp = m_Scene.LatestFrameTimestamp();
+      if (sampleTimestamp > 0 && sampleTimestamp != m_LatencySampleTimestamp) {
+        m_Latency.AddSample(1.0e-6 * static_cast<double>(m_Controller.now() - sampleTimestamp));
+        m_LatencySampleTimestamp = sampleTimestamp;
+      }
+    }
 
     Globals::prevFrameTime = Globals::curFrameTime;
   }
+
+  if (m_Options.headless || m_Options.frameCount > 0) {
+    std::cout << "Timing summary over " << frameStats.Count() << " frames, " << frameStats.Total() << " s wall time:" << std::endl;
+    updateStats.Print(std::cout);
+    renderStats.Print(std::cout);
+    frameStats.Print(std::cout);
+    if (frameStats.Count() > 0) {
+      const Leap::GL::Shader::UniformUploadStats& uniformStats = Leap::GL::Shader::UploadStats();
+      // without the shadow copies, every skipped upload would have been issued as well
+      std::cout << "glUniform calls per frame: " << uniformStats.uploaded / frameStats.Count()
+                << " (" << (uniformStats.uploaded + uniformStats.skipped) / frameStats.Count() << " without skipping unchanged or unused uniforms)" << std::endl;
+      std::cout << "GL state changes per frame: " << stateCache.Stats().issued / frameStats.Count()
+                << " (" << stateCache.Stats().skipped / frameStats.Count() << " skipped as redundant)" << std::endl;
+    }
+    if (m_Scene.CoalescedFrameCount() > 0) {
+      std::cout << "Coalesced " << m_Scene.CoalescedFrameCount() << " tracking frames" << std::endl;
+    }
+    if (m_Latency.Stats().Count() > 0) {
+      m_Latency.Stats().Print(std::cout);
+      std::cout << "Prediction horizon " << 1000.0*m_Latency.Horizon() << " ms" << (m_Latency.IsAutoTuned() ? " (auto)" : "") << std::endl;
+    }
+  }
 }
 
 void ARScreen::Filter(void) {
@@ -145,7 +304,14 @@ void ARScreen::HandleWindowEvents() {
 
 void ARScreen::Update() {
   m_update(&Updatable::Tick)(Globals::timeBetweenFrames);
-  m_Scene.Update(m_Listener.TakeAccumulatedFrames());
+  m_Scene.SetPredictionHorizon(m_Latency.Horizon());
+  const std::deque<Leap::Frame> frames = m_Replay ? m_Replay->TakeAccumulatedFrames() : m_Listener.TakeAccumulatedFrames();
+  if (m_Recorder) {
+    for (size_t i = 0; i < frames.size(); i++) {
+      m_Recorder->WriteFrame(frames[i]);
+    }
+  }
+  m_Scene.Update(frames);
 }
 
 void ARScreen::Render() {
@@ -157,27 +323,7 @@ void ARScreen::Render() {
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-#if 0
-    const float leapBaseline = 40.0f;
-#else
-    const float leapBaseline = 64.0f;
-#endif
-
-    const float OCULUS_BASELINE = 64.0f; // TODO: Get this value directly from the SDK
-
-    const EigenTypes::Matrix4x4f avgView = 0.5f*(m_Oculus.EyeView(0) + m_Oculus.EyeView(1));
-    EigenTypes::Matrix4x4f inputTransform = avgView.inverse();
-    EigenTypes::Matrix3x3f conventionConv;
-    conventionConv << -EigenTypes::Vector3f::UnitX(), -EigenTypes::Vector3f::UnitZ(), -EigenTypes::Vector3f::UnitY();
-#if 1
-    inputTransform.block<3, 3>(0, 0) *= (OCULUS_BASELINE / leapBaseline) * conventionConv;
-#else
-    inputTransform.block<3, 3>(0, 0) *= conventionConv;
-#endif
-
-    EigenTypes::Matrix3x3 rotation = inputTransform.block<3, 3>(0, 0).cast<double>();
-    EigenTypes::Vector3 translation = inputTransform.block<3, 1>(0, 3).cast<double>();
-    m_Scene.SetInputTransform(rotation, translation);
+    SetInputTransformFromView(0.5f*(m_Oculus.EyeView(0) + m_Oculus.EyeView(1)));
 
     for (int i=0; i<2; i++) {
       const ovrRecti& rect = m_Oculus.EyeViewport(i);
@@ -201,6 +347,54 @@ void ARScreen::Render() {
 
 }
 
+void ARScreen::RenderHeadless() {
+  // Renders both eyes side by side into the offscreen framebuffer, as though
+  // to an HMD positioned at the origin.
+  m_Offscreen.Bind();
+  glViewport(0, 0, m_Offscreen.Width(), m_Offscreen.Height());
+  glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  const EigenTypes::Matrix4x4f view = EigenTypes::Matrix4x4f::Identity();
+  SetInputTransformFromView(view);
+
+  const int eyeWidth = m_Offscreen.Width() / 2;
+  const int eyeHeight = m_Offscreen.Height();
+  EigenTypes::Matrix4x4 proj;
+  Leap::GL::Projection::SetPerspective_UsingFOVAndAspectRatio(proj, M_PI / 2.0, static_cast<double>(eyeWidth) / eyeHeight, 1.0, 10000.0);
+  for (int i=0; i<2; i++) {
+    glViewport(i*eyeWidth, 0, eyeWidth, eyeHeight);
+    m_Scene.Render(proj.cast<float>(), view, i);
+  }
+
+  // make sure the timing includes the work done by the GL implementation
+  glFinish();
+  m_Offscreen.Unbind();
+}
+
+void ARScreen::SetInputTransformFromView(const EigenTypes::Matrix4x4f& avgView) {
+#if 0
+  const float leapBaseline = 40.0f;
+#else
+  const float leapBaseline = 64.0f;
+#endif
+
+  const float OCULUS_BASELINE = 64.0f; // TODO: Get this value directly from the SDK
+
+  EigenTypes::Matrix4x4f inputTransform = avgView.inverse();
+  EigenTypes::Matrix3x3f conventionConv;
+  conventionConv << -EigenTypes::Vector3f::UnitX(), -EigenTypes::Vector3f::UnitZ(), -EigenTypes::Vector3f::UnitY();
+#if 1
+  inputTransform.block<3, 3>(0, 0) *= (OCULUS_BASELINE / leapBaseline) * conventionConv;
+#else
+  inputTransform.block<3, 3>(0, 0) *= conventionConv;
+#endif
+
+  EigenTypes::Matrix3x3 rotation = inputTransform.block<3, 3>(0, 0).cast<double>();
+  EigenTypes::Vector3 translation = inputTransform.block<3, 1>(0, 3).cast<double>();
+  m_Scene.SetInputTransform(rotation, translation);
+}
+
 void ARScreen::InitMirror() {
 #if _WIN32
   if (m_ShowMirror) {
@@ -1,12 +1,49 @@
 #pragma once
 #include <autowiring/autowiring.h>
+#include "LeapListener/FrameRecording.h"
+#include "LeapListener/FrameReplaySource.h"
 #include "LeapListener/LeapListener.h"
 #include "OculusVR/OculusVR.h"
+#include "LatencyMonitor.h"
+#include "OffscreenTarget.h"
 #include "Window.h"
 #include "Scene.h"
 
 struct ARScreenContext {};
 
+// Command line options.
+struct ARScreenOptions {
+  ARScreenOptions() :
+    recordImages(false),
+    replayRealTime(false),
+    headless(false),
+    headlessWidth(1920),
+    headlessHeight(1080),
+    frameCount(0),
+    fixedStep(0.0),
+    predictionHorizon(-1.0),
+    maxFramesPerUpdate(4),
+    validateGLState(false),
+    validateIntersections(false)
+  { }
+
+  bool Parse(int argc, char **argv);
+
+  std::string recordPath;   // --record <file>: write tracking frames to a recording
+  bool recordImages;        // --record-images: include the IR images in the recording
+  std::string replayPath;   // --replay <file>: use a recording instead of the Leap service
+  bool replayRealTime;      // --realtime: replay at the recorded pace instead of one frame per update
+  bool headless;            // --headless: render offscreen, with no window and no Oculus
+  int headlessWidth;        // --size <width>x<height>: offscreen framebuffer size
+  int headlessHeight;
+  int frameCount;           // --frames <n>: exit after n frames and print a timing summary (0 runs forever)
+  double fixedStep;         // --step <seconds>: advance the clock by a fixed step per frame (0 uses the wall clock)
+  double predictionHorizon; // --predict <seconds|auto>: how far ahead to draw the hands (negative tunes it from the measured latency)
+  int maxFramesPerUpdate;   // --coalesce <n>: process at most the newest n tracking frames per update (0 processes all)
+  bool validateGLState;     // --validate-gl-state: cross-check the cached GL bindings against glGet* (slow)
+  bool validateIntersections; // --validate-intersections: cross-check the batch hand intersections against HandInfo's (slow)
+};
+
 class Updatable;
 
 class ARScreen :
@@ -18,24 +55,38 @@ public:
   ~ARScreen(void);
 
 public:
+  void SetOptions(const ARScreenOptions& options) { m_Options = options; }
   void Main(void);
   void Filter(void) override;
 
   void HandleWindowEvents();
   void Update();
   void Render();
+  void RenderHeadless();
+  void SetInputTransformFromView(const EigenTypes::Matrix4x4f& avgView);
 
   void InitMirror();
   void ShutdownMirror();
 
   AutoFired<Updatable> m_update;
 
+  // Tracking frames are handed off through a lock-free ring of this many frames;
+  // at 200 Hz tracking this is well over a tenth of a second of slack.
+  static const size_t FRAME_RING_CAPACITY = 32;
+
   Scene m_Scene;
   Window m_Window;
+  OffscreenTarget m_Offscreen;
   OculusVR m_Oculus;
   Leap::Controller m_Controller;
   LeapListener m_Listener;
 
+  ARScreenOptions m_Options;
+  std::shared_ptr<FrameRecorder> m_Recorder;
+  std::shared_ptr<FrameReplaySource> m_Replay;
+  LatencyMonitor m_Latency;
+  int64_t m_LatencySampleTimestamp; // timestamp of the frame most recently sampled by m_Latency
+
   // for mirroring
   std::thread m_MirrorThread;
 #if _WIN32
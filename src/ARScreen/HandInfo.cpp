@@ -2,16 +2,20 @@
 #include "HandInfo.h"
 
 HandInfo::HandInfo() :
+  m_palmVelocity(EigenTypes::Vector3::Zero()),
+  m_creationTimeSeconds(0.0),
   m_lastUpdateTimeSeconds(0.0),
+  m_predictionSeconds(0.0),
   m_confidence(0.0),
+  m_numExtendedFingers(0),
   m_needRiggedHandUpdate(true),
-  m_creationTimeSeconds(0.0),
-  m_firstUpdate(true),
-  m_numExtendedFingers(0)
+  m_firstUpdate(true)
 {
   m_capsulePrim = std::shared_ptr<CapsulePrim>(new CapsulePrim());
   //m_capsulePrim->Material().Uniform<AMBIENT_LIGHTING_PROPORTION>() = 1.0f;
 
+  m_capsuleBatch = std::shared_ptr<InstancedBatch>(new InstancedBatch());
+
   m_palmPrim = std::shared_ptr<RadialPolygonPrim>(new RadialPolygonPrim());
   //m_palmPrim->Material().Uniform<AMBIENT_LIGHTING_PROPORTION>() = 1.0f;
 
@@ -19,24 +23,26 @@ HandInfo::HandInfo() :
   //m_armPrim->Material().Uniform<AMBIENT_LIGHTING_PROPORTION>() = 1.0f;
 }
 
-void HandInfo::Update(const Leap::Hand& hand, float deltaTime, const EigenTypes::Matrix3x3& rotation, const EigenTypes::Vector3& translation) {
+void HandInfo::Update(const Leap::Hand& hand, float deltaTime, const EigenTypes::Matrix3x3& rotation, const EigenTypes::Vector3& translation, int numSteps) {
   assert(hand.isValid());
 
   const double curTimeSeconds = timestampToSeconds(hand.frame().timestamp());
 
+  const bool firstUpdate = m_firstUpdate;
   if (m_firstUpdate) {
     m_creationTimeSeconds = curTimeSeconds;
     m_firstUpdate = false;
   }
 
   const EigenTypes::Vector3 palmPosition = rotation * hand.palmPosition().toVector3<EigenTypes::Vector3>() + translation;
+  m_palmVelocity = rotation * hand.palmVelocity().toVector3<EigenTypes::Vector3>();
   const float falloffMult = 1.0f;
 
   const float timeVisibleMult = SmootherStep(std::min(1.0f, 6.0f*static_cast<float>(curTimeSeconds - m_creationTimeSeconds)));
   const float confidenceMult = SmootherStep(std::min(1.0f, 2.0f * hand.confidence()));
   m_confidence.SetSmoothStrength(0.5f);
   m_confidence.SetGoal(timeVisibleMult * confidenceMult * falloffMult);
-  m_confidence.Update(deltaTime);
+  m_confidence.Update(deltaTime / numSteps, numSteps);
 
   int pointIdx = 0;
 
@@ -70,6 +76,13 @@ void HandInfo::Update(const Leap::Hand& hand, float deltaTime, const EigenTypes:
     }
   }
 
+  if (firstUpdate) {
+    // there's no previous position to difference against
+    for (int i = 0; i < NUM_HAND_POINTS; i++) {
+      m_handPoints[i].velocity.setZero();
+    }
+  }
+
   m_lastSeenHand = hand;
 
   m_lastUpdateTimeSeconds = curTimeSeconds;
@@ -77,11 +90,12 @@ void HandInfo::Update(const Leap::Hand& hand, float deltaTime, const EigenTypes:
   m_needRiggedHandUpdate = true;
 }
 
-void HandInfo::UpdateWithoutHand(float deltaTime) {
+void HandInfo::UpdateWithoutHand(float deltaTime, int numSteps) {
   m_confidence.SetSmoothStrength(0.8f);
   m_confidence.SetGoal(0.0);
-  m_confidence.Update(deltaTime);
+  m_confidence.Update(deltaTime / numSteps, numSteps);
   m_numExtendedFingers = 0;
+  m_palmVelocity.setZero();
 
   for (int i = 0; i < NUM_HAND_POINTS; i++) {
     m_handPoints[i].velocity.setZero();
@@ -108,22 +122,28 @@ void HandInfo::DrawCapsuleHand(RenderState& renderer, const EigenTypes::Matrix3x
 
   const EigenTypes::Matrix3x3 armBasis = rotation * toEigen(hand.arm().basis());
   const EigenTypes::Matrix3x3 handBasis = rotation * toEigen(hand.basis());
-  const EigenTypes::Vector3 palmPosition = rotation * hand.palmPosition().toVector3<EigenTypes::Vector3>() + translation;
+  const EigenTypes::Vector3 palmPosition = rotation * hand.palmPosition().toVector3<EigenTypes::Vector3>() + translation + m_predictionSeconds * m_palmVelocity;
 
   const EigenTypes::Matrix3x3 basisRot = RotationMatrixFromEulerAngles(M_PI / 2.0, 0.0, M_PI);
   const Leap::FingerList fingers = hand.fingers();
+  // the bones are positioned by m_capsulePrim, then all drawn at once
+  m_capsuleBatch->Clear();
   for (int i = 0; i<5; i++) {
     const Leap::Finger finger = fingers[i];
     for (int j = 1; j<4; j++) {
       const Leap::Bone bone = finger.bone(static_cast<Leap::Bone::Type>(j));
       const EigenTypes::Matrix3x3 boneBasis = rotation * toEigen(bone.basis());
-      m_capsulePrim->Translation() = rotation * bone.center().toVector3<EigenTypes::Vector3>() + translation;
+      // bone j of a finger runs between its points j and j+1
+      const int pointIdx = i*POINTS_PER_FINGER + j;
+      const EigenTypes::Vector3 boneOffset = 0.5*(PredictedOffset(pointIdx) + PredictedOffset(pointIdx + 1));
+      m_capsulePrim->Translation() = rotation * bone.center().toVector3<EigenTypes::Vector3>() + translation + boneOffset;
       m_capsulePrim->SetHeight(bone.length());
       m_capsulePrim->SetRadius(radiusMult*0.5*bone.width());
       m_capsulePrim->LinearTransformation() = boneBasis * basisRot;
-      passthrough->DrawStencilObject(m_capsulePrim.get(), renderer, viewWidth, viewX, viewHeight, l00, l11, l03, opacity);
+      m_capsuleBatch->Add(*m_capsulePrim);
     }
   }
+  passthrough->DrawStencilInstances(m_capsuleBatch.get(), renderer, viewWidth, viewX, viewHeight, l00, l11, l03, opacity);
 
   {
     const double palmRadius = 15;
@@ -166,7 +186,7 @@ void HandInfo::DrawCapsuleHand(RenderState& renderer, const EigenTypes::Matrix3x
       m_armPrim->SetPoint(i, armPoints[i]);
     }
     m_armPrim->SetRadius(radiusMult*armRadius);
-    m_armPrim->Translation() = rotation * armCenter + translation;
+    m_armPrim->Translation() = rotation * armCenter + translation + m_predictionSeconds * m_palmVelocity;
     m_armPrim->LinearTransformation() = armBasis;
     passthrough->DrawStencilObject(m_armPrim.get(), renderer, viewWidth, viewX, viewHeight, l00, l11, l03, opacity);
   }
@@ -179,6 +199,7 @@ HandInfo::IntersectionVector HandInfo::IntersectRectangle(const RectanglePrim& p
   if (normal.z() < 0) {
     normal *= -1.0;
   }
+  const Eigen::Matrix3d inverseLinear = linear.inverse();
   const Eigen::Vector3d scale(linear.row(0).norm(), linear.row(1).norm(), linear.row(2).norm());
   IntersectionVector intersections;
 
@@ -202,7 +223,7 @@ HandInfo::IntersectionVector HandInfo::IntersectRectangle(const RectanglePrim& p
         if (IntersectPlane(point1.point, dir, prim.Translation(), normal, t)) {
           const Eigen::Vector3d surfacePoint = point1.point + t * dir;
 
-          const Eigen::Vector3d untransformed = linear.inverse() * (surfacePoint - center);
+          const Eigen::Vector3d untransformed = inverseLinear * (surfacePoint - center);
           if (std::fabs(untransformed.x()) < 0.5*prim.Size().x() && std::fabs(untransformed.y()) < 0.5*prim.Size().y()) {
             const double ratio = t / distBetweenPoints; 
             intersection.radius = (1.0-ratio)*point1.radius + ratio*point2.radius;
@@ -226,6 +247,7 @@ HandInfo::IntersectionVector HandInfo::IntersectDisk(const Disk& prim) const {
   const Eigen::Vector3d center = prim.Translation();
   const Eigen::Matrix3d linear = prim.LinearTransformation();
   const Eigen::Vector3d normal = prim.LinearTransformation().col(2).normalized();
+  const Eigen::Matrix3d inverseLinear = linear.inverse();
   const Eigen::Vector3d scale(linear.row(0).norm(), linear.row(1).norm(), linear.row(2).norm());
   IntersectionVector intersections;
 
@@ -249,7 +271,7 @@ HandInfo::IntersectionVector HandInfo::IntersectDisk(const Disk& prim) const {
         if (IntersectPlane(point1.point, dir, prim.Translation(), normal, t)) {
           const Eigen::Vector3d surfacePoint = point1.point + t * dir;
 
-          const Eigen::Vector3d untransformed = linear.inverse() * (surfacePoint - center);
+          const Eigen::Vector3d untransformed = inverseLinear * (surfacePoint - center);
           if (untransformed.norm() < prim.Radius()) {
             const double ratio = t / distBetweenPoints;
             intersection.radius = (1.0-ratio)*point1.radius + ratio*point2.radius;
@@ -10,18 +10,25 @@
 class HandInfo {
 public:
   HandInfo();
-  void Update(const Leap::Hand& hand, float deltaTime, const EigenTypes::Matrix3x3& rotation, const EigenTypes::Vector3& translation);
-  void UpdateWithoutHand(float deltaTime);
+  // deltaTime is the time since the previous update, which spans numSteps
+  // tracking frames if the frames in between were skipped.
+  void Update(const Leap::Hand& hand, float deltaTime, const EigenTypes::Matrix3x3& rotation, const EigenTypes::Vector3& translation, int numSteps = 1);
+  void UpdateWithoutHand(float deltaTime, int numSteps = 1);
   double GetLastUpdateTime() const { return m_lastUpdateTimeSeconds; }
   double GetConfidence() const { return m_confidence.Value(); }
 
   const Leap::Hand& GetLastSeenHand() const { return m_lastSeenHand; }
 
+  // The hand is drawn extrapolated this many seconds past its last update,
+  // along the velocities of its points, to make up for the pipeline latency.
+  void SetPredictionHorizon(double seconds) { m_predictionSeconds = seconds; }
+  double PredictionHorizon() const { return m_predictionSeconds; }
+
   void DrawSimpleHand(RenderState& renderer) const;
   void DrawCapsuleHand(RenderState& renderer, const EigenTypes::Matrix3x3& rotation, const EigenTypes::Vector3& translation, ImagePassthrough* passthrough) const;
 
   struct HandPoint {
-    HandPoint() : point(EigenTypes::Vector3::Zero()), velocity(EigenTypes::Vector3::Zero()), isTip(false) {}
+    HandPoint() : point(EigenTypes::Vector3::Zero()), velocity(EigenTypes::Vector3::Zero()), radius(0.0f), isTip(false), isExtended(false) {}
     void Update(const EigenTypes::Vector3& pos, float deltaTime) {
       velocity = (pos - point) / deltaTime;
       point = pos;
@@ -34,6 +41,8 @@ public:
   };
 
   HandPoint& GetHandPoint(int idx) { return m_handPoints[idx]; }
+  // The displacement of a point over the prediction horizon.
+  EigenTypes::Vector3 PredictedOffset(int idx) const { return m_predictionSeconds * m_handPoints[idx].velocity; }
   const HandPoint& GetHandPoint(int idx) const { return m_handPoints[idx]; }
   int NumExtendedFingers() const { return m_numExtendedFingers; }
   double CreationTimeSeconds() const { return m_creationTimeSeconds; }
@@ -57,8 +66,10 @@ public:
 private:
 
   HandPoint m_handPoints[NUM_HAND_POINTS];
+  EigenTypes::Vector3 m_palmVelocity;
   double m_creationTimeSeconds;
   double m_lastUpdateTimeSeconds;
+  double m_predictionSeconds;
 
   Smoothed<double> m_confidence;
   int m_numExtendedFingers;
@@ -68,6 +79,7 @@ private:
   bool m_firstUpdate;
 
   mutable std::shared_ptr<CapsulePrim> m_capsulePrim;
+  mutable std::shared_ptr<InstancedBatch> m_capsuleBatch;
   mutable std::shared_ptr<RadialPolygonPrim> m_palmPrim;
   mutable std::shared_ptr<RadialPolygonPrim> m_armPrim;
 
@@ -0,0 +1,273 @@
+#include "stdafx.h"
+#include "HandIntersection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__AVX__)
+  #include <immintrin.h>
+  #define HAND_INTERSECTION_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define HAND_INTERSECTION_SSE 1
+#endif
+
+namespace {
+
+static_assert(HandTable::POINT_CAPACITY <= 32, "Point masks are stored in 32 bits");
+
+// Bit i is set if point i starts a bone, i.e. if points i and i+1 are joints of
+// the same finger.
+uint32_t boneStartMask() {
+  static const uint32_t mask = [] {
+    uint32_t result = 0;
+    const int* starts = HandTable::BoneStartIndices();
+    for (int i = 0; i < HandTable::NUM_BONES; i++) {
+      result |= 1u << starts[i];
+    }
+    return result;
+  }();
+  return mask;
+}
+
+// Returns a mask with bit i set if point i is strictly in front of the target
+// plane.  Also stores the signed distances to the plane.
+uint32_t pointsAbovePlane(const HandTable::Slot& hand, const IntersectionTarget& target, float* distances) {
+  uint32_t above = 0;
+#if HAND_INTERSECTION_AVX
+  const __m256 cx = _mm256_set1_ps(target.center[0]);
+  const __m256 cy = _mm256_set1_ps(target.center[1]);
+  const __m256 cz = _mm256_set1_ps(target.center[2]);
+  const __m256 nx = _mm256_set1_ps(target.normal[0]);
+  const __m256 ny = _mm256_set1_ps(target.normal[1]);
+  const __m256 nz = _mm256_set1_ps(target.normal[2]);
+  const __m256 zero = _mm256_setzero_ps();
+  for (int i = 0; i < HandTable::POINT_CAPACITY; i += 8) {
+    const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(hand.x + i), cx);
+    const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(hand.y + i), cy);
+    const __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(hand.z + i), cz);
+    const __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, nx), _mm256_mul_ps(dy, ny)), _mm256_mul_ps(dz, nz));
+    _mm256_storeu_ps(distances + i, d);
+    above |= static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(d, zero, _CMP_GT_OQ))) << i;
+  }
+#elif HAND_INTERSECTION_SSE
+  const __m128 cx = _mm_set1_ps(target.center[0]);
+  const __m128 cy = _mm_set1_ps(target.center[1]);
+  const __m128 cz = _mm_set1_ps(target.center[2]);
+  const __m128 nx = _mm_set1_ps(target.normal[0]);
+  const __m128 ny = _mm_set1_ps(target.normal[1]);
+  const __m128 nz = _mm_set1_ps(target.normal[2]);
+  const __m128 zero = _mm_setzero_ps();
+  for (int i = 0; i < HandTable::POINT_CAPACITY; i += 4) {
+    const __m128 dx = _mm_sub_ps(_mm_loadu_ps(hand.x + i), cx);
+    const __m128 dy = _mm_sub_ps(_mm_loadu_ps(hand.y + i), cy);
+    const __m128 dz = _mm_sub_ps(_mm_loadu_ps(hand.z + i), cz);
+    const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, nx), _mm_mul_ps(dy, ny)), _mm_mul_ps(dz, nz));
+    _mm_storeu_ps(distances + i, d);
+    above |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpgt_ps(d, zero))) << i;
+  }
+#else
+  for (int i = 0; i < HandTable::POINT_CAPACITY; i++) {
+    const float d = (hand.x[i] - target.center[0])*target.normal[0]
+                  + (hand.y[i] - target.center[1])*target.normal[1]
+                  + (hand.z[i] - target.center[2])*target.normal[2];
+    distances[i] = d;
+    if (d > 0) {
+      above |= 1u << i;
+    }
+  }
+#endif
+  return above;
+}
+
+// The relative tolerance of MatchesIntersections, well above single-precision
+// rounding of hand coordinates (hundreds of millimeters) and well below a millimeter.
+const double MATCH_TOLERANCE = 1e-3;
+
+bool nearlyEqual(double a, double b) {
+  return std::fabs(a - b) <= MATCH_TOLERANCE * std::max(1.0, std::max(std::fabs(a), std::fabs(b)));
+}
+
+// Vectors are compared as a whole, since a small component of a large vector
+// carries the rounding error of the whole.
+bool nearlyEqual(const float* a, const Eigen::Vector3d& b) {
+  const Eigen::Vector3d a3 = Eigen::Map<const Eigen::Vector3f>(a).cast<double>();
+  return (a3 - b).norm() <= MATCH_TOLERANCE * std::max(1.0, std::max(a3.norm(), b.norm()));
+}
+
+// Returns true if a crossing at the given point (including the normal offset) is
+// near enough to a hand point or to the target's edge that rounding may decide
+// whether it is found.
+bool isBorderline(const HandTable::Slot& hand, const IntersectionTarget& target, const Eigen::Vector3d& point) {
+  const Eigen::Vector3d normal(target.normal[0], target.normal[1], target.normal[2]);
+  const Eigen::Vector3d center(target.center[0], target.center[1], target.center[2]);
+  const Eigen::Vector3d surface = point - normal;
+  const double tolerance = MATCH_TOLERANCE * std::max(1.0, surface.norm());
+  for (int i = 0; i < HandTable::NUM_POINTS; i++) {
+    if ((surface - Eigen::Vector3d(hand.x[i], hand.y[i], hand.z[i])).norm() <= tolerance) {
+      return true;
+    }
+  }
+  const Eigen::Matrix3d inverseLinear = Eigen::Map<const Eigen::Matrix<float,3,3,Eigen::RowMajor>>(target.inverseLinear).cast<double>();
+  const Eigen::Vector3d untransformed = inverseLinear * (surface - center);
+  if (target.shape == IntersectionTarget::RECTANGLE) {
+    return std::fabs(std::fabs(untransformed.x()) - target.halfWidth) <= MATCH_TOLERANCE * std::max(1.0f, target.halfWidth)
+        || std::fabs(std::fabs(untransformed.y()) - target.halfHeight) <= MATCH_TOLERANCE * std::max(1.0f, target.halfHeight);
+  }
+  return std::fabs(untransformed.norm() - target.radius) <= MATCH_TOLERANCE * std::max(1.0f, target.radius);
+}
+
+void fillTarget(IntersectionTarget& target, const Eigen::Vector3d& center, const Eigen::Matrix3d& linear, const Eigen::Vector3d& normal) {
+  const Eigen::Matrix3d inverse = linear.inverse();
+  for (int i = 0; i < 3; i++) {
+    target.center[i] = static_cast<float>(center[i]);
+    target.normal[i] = static_cast<float>(normal[i]);
+    for (int j = 0; j < 3; j++) {
+      target.inverseLinear[3*i + j] = static_cast<float>(inverse(i, j));
+    }
+  }
+  target.halfWidth = 0.0f;
+  target.halfHeight = 0.0f;
+  target.radius = 0.0f;
+}
+
+}
+
+IntersectionTarget IntersectionTarget::FromRectangle(const RectanglePrim& prim) {
+  const Eigen::Matrix3d linear = prim.LinearTransformation();
+  Eigen::Vector3d normal = linear.col(2).normalized();
+  if (normal.z() < 0) {
+    normal *= -1.0;
+  }
+  IntersectionTarget target;
+  fillTarget(target, prim.Translation(), linear, normal);
+  target.shape = RECTANGLE;
+  target.halfWidth = static_cast<float>(0.5*prim.Size().x());
+  target.halfHeight = static_cast<float>(0.5*prim.Size().y());
+  return target;
+}
+
+IntersectionTarget IntersectionTarget::FromDisk(const Disk& prim) {
+  const Eigen::Matrix3d linear = prim.LinearTransformation();
+  IntersectionTarget target;
+  fillTarget(target, prim.Translation(), linear, linear.col(2).normalized());
+  target.shape = DISK;
+  target.radius = static_cast<float>(prim.Radius());
+  return target;
+}
+
+size_t IntersectHandBatch(const HandTable::Slot& hand, const IntersectionTarget& target, int targetIdx, BatchIntersection* results, size_t capacity) {
+  float distances[HandTable::POINT_CAPACITY];
+  const uint32_t above = pointsAbovePlane(hand, target, distances);
+
+  // a bone crosses the plane if its two endpoints are on different sides
+  uint32_t crossings = (above ^ (above >> 1)) & boneStartMask();
+
+  size_t count = 0;
+  while (crossings) {
+    int i = 0;
+    while (!(crossings & (1u << i))) {
+      i++;
+    }
+    crossings &= ~(1u << i);
+
+    const float d1 = distances[i];
+    const float d2 = distances[i + 1];
+    if (d1 == 0.0f) {
+      // a bone starting exactly on the plane meets it at t == 0, which IntersectPlane rejects
+      continue;
+    }
+    const float ratio = d1 / (d1 - d2);
+    const float surface[3] = {
+      hand.x[i] + ratio*(hand.x[i + 1] - hand.x[i]),
+      hand.y[i] + ratio*(hand.y[i + 1] - hand.y[i]),
+      hand.z[i] + ratio*(hand.z[i + 1] - hand.z[i])
+    };
+    const float offset[3] = { surface[0] - target.center[0], surface[1] - target.center[1], surface[2] - target.center[2] };
+    const float* inv = target.inverseLinear;
+    const float ux = inv[0]*offset[0] + inv[1]*offset[1] + inv[2]*offset[2];
+    const float uy = inv[3]*offset[0] + inv[4]*offset[1] + inv[5]*offset[2];
+
+    bool inside;
+    if (target.shape == IntersectionTarget::RECTANGLE) {
+      inside = std::fabs(ux) < target.halfWidth && std::fabs(uy) < target.halfHeight;
+    } else {
+      const float uz = inv[6]*offset[0] + inv[7]*offset[1] + inv[8]*offset[2];
+      inside = ux*ux + uy*uy + uz*uz < target.radius*target.radius;
+    }
+    if (!inside) {
+      continue;
+    }
+
+    if (count < capacity) {
+      BatchIntersection& result = results[count];
+      result.targetIdx = targetIdx;
+      result.handId = hand.id;
+      for (int k = 0; k < 3; k++) {
+        result.point[k] = surface[k] + target.normal[k];
+      }
+      result.velocity[0] = (1.0f - ratio)*hand.vx[i] + ratio*hand.vx[i + 1];
+      result.velocity[1] = (1.0f - ratio)*hand.vy[i] + ratio*hand.vy[i + 1];
+      result.velocity[2] = (1.0f - ratio)*hand.vz[i] + ratio*hand.vz[i + 1];
+      result.radius = (1.0f - ratio)*hand.radius[i] + ratio*hand.radius[i + 1];
+      result.confidence = hand.confidence;
+    }
+    count++;
+  }
+  return count;
+}
+
+size_t IntersectHandsBatch(const HandTable& hands, const IntersectionTarget* targets, size_t numTargets, BatchIntersection* results, size_t capacity) {
+  size_t count = 0;
+  for (size_t t = 0; t < numTargets; t++) {
+    for (int h = 0; h < hands.Count(); h++) {
+      const HandTable::Slot& hand = hands.GetSlot(hands.ActiveSlotIndex(h));
+      const size_t remaining = count < capacity ? capacity - count : 0;
+      count += IntersectHandBatch(hand, targets[t], static_cast<int>(t), results + (count < capacity ? count : capacity), remaining);
+    }
+  }
+  return count;
+}
+
+void AppendIntersections(const BatchIntersection* results, size_t count, HandInfo::IntersectionVector& intersections) {
+  HandInfo::Intersection intersection;
+  for (size_t i = 0; i < count; i++) {
+    const BatchIntersection& result = results[i];
+    intersection.point = Eigen::Map<const Eigen::Vector3f>(result.point).cast<double>();
+    intersection.radius = result.radius;
+    intersection.confidence = result.confidence;
+    intersection.velocity = Eigen::Map<const Eigen::Vector3f>(result.velocity).cast<double>();
+    intersections.push_back(intersection);
+  }
+}
+
+bool MatchesIntersections(const HandTable::Slot& hand, const IntersectionTarget& target, const BatchIntersection* results, size_t count, const HandInfo::IntersectionVector& expected) {
+  // both are in finger and bone order, so matching crossings line up once the
+  // borderline ones are skipped
+  size_t i = 0;
+  size_t j = 0;
+  while (i < count || j < expected.size()) {
+    if (i < count && j < expected.size()) {
+      const BatchIntersection& result = results[i];
+      const HandInfo::Intersection& intersection = expected[j];
+      if (nearlyEqual(result.point, intersection.point)) {
+        if (!nearlyEqual(result.velocity, intersection.velocity) || !nearlyEqual(result.radius, intersection.radius) ||
+            !nearlyEqual(result.confidence, intersection.confidence)) {
+          return false;
+        }
+        i++;
+        j++;
+        continue;
+      }
+    }
+    if (i < count && isBorderline(hand, target, Eigen::Map<const Eigen::Vector3f>(results[i].point).cast<double>())) {
+      i++;
+    } else if (j < expected.size() && isBorderline(hand, target, expected[j].point)) {
+      j++;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "HandTable.h"
+#include "Primitives/Primitives.h"
+
+// Batch intersection of the bones of every hand in a HandTable against a set of
+// planar targets (rectangles and disks).  This is the batched equivalent of
+// HandInfo::IntersectRectangle and HandInfo::IntersectDisk, in single precision.
+// For each hand and target it finds the same crossings, in the same (finger, then
+// bone) order, except that a crossing within rounding of a bone's endpoint or of
+// the target's edge may be found by only one of them (see MatchesIntersections).
+// IntersectHandsBatch orders its results by target, then by the hands' order in
+// the table (HandTable::ActiveSlotIndex), which isn't the HandInfoMap's id order.
+//
+// The side of the target plane that each hand point lies on is computed for all
+// points of a hand at once, using AVX or SSE when the compiler targets them and
+// scalar code otherwise.  The bones which cross the plane are then found with
+// a few bit operations, and only those are finished individually.
+
+// A rectangle or disk, with everything that does not depend on the hands
+// (normal, inverse transform, extents) computed once up front.
+struct IntersectionTarget {
+  enum Shape { RECTANGLE, DISK };
+
+  static IntersectionTarget FromRectangle(const RectanglePrim& prim);
+  static IntersectionTarget FromDisk(const Disk& prim);
+
+  Shape shape;
+  float center[3];
+  float normal[3];
+  float inverseLinear[9]; // row-major
+  float halfWidth;        // rectangles only
+  float halfHeight;       // rectangles only
+  float radius;           // disks only
+};
+
+struct BatchIntersection {
+  int targetIdx;
+  int handId;
+  float point[3];  // the crossing point, offset by the target's normal
+  float velocity[3];
+  float radius;
+  float confidence;
+};
+
+// Intersects every hand in the table with every target, writing at most
+// capacity results to the caller-provided array.  Returns the number of
+// intersections found, which may exceed capacity (only the first capacity are
+// written), so the caller can grow its storage and retry.
+size_t IntersectHandsBatch(const HandTable& hands, const IntersectionTarget* targets, size_t numTargets, BatchIntersection* results, size_t capacity);
+
+// As above, for a single hand slot of the table and a single target.  There are
+// at most HandTable::NUM_BONES results.
+size_t IntersectHandBatch(const HandTable::Slot& hand, const IntersectionTarget& target, int targetIdx, BatchIntersection* results, size_t capacity);
+
+// Appends the given results to intersections, converted to HandInfo's format.
+void AppendIntersections(const BatchIntersection* results, size_t count, HandInfo::IntersectionVector& intersections);
+
+// Returns true iff the results for one hand and target agree with what
+// HandInfo::IntersectRectangle or IntersectDisk found for them (expected): each
+// crossing's point, velocity and radius must agree to within a relative tolerance,
+// and a crossing found by only one of them must be a borderline one, within that
+// tolerance of a bone's endpoint or of the target's edge.
+bool MatchesIntersections(const HandTable::Slot& hand, const IntersectionTarget& target, const BatchIntersection* results, size_t count, const HandInfo::IntersectionVector& expected);
@@ -0,0 +1,124 @@
+#include "stdafx.h"
+#include "HandTable.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+struct BoneIndices {
+  BoneIndices() {
+    int boneIdx = 0;
+    for (int finger = 0; finger < 5; finger++) {
+      for (int bone = 0; bone < HandInfo::BONES_PER_FINGER; bone++) {
+        start[boneIdx] = finger * HandInfo::POINTS_PER_FINGER + bone;
+        end[boneIdx] = start[boneIdx] + 1;
+        boneIdx++;
+      }
+    }
+  }
+  int start[HandTable::NUM_BONES];
+  int end[HandTable::NUM_BONES];
+};
+
+const BoneIndices& boneIndices() {
+  static const BoneIndices indices;
+  return indices;
+}
+
+}
+
+HandTable::HandTable() :
+  m_Count(0),
+  m_OverflowCount(0)
+{
+  std::memset(m_Slots, 0, sizeof(m_Slots));
+  for (int i = 0; i < MAX_HANDS; i++) {
+    m_Occupied[i] = false;
+    m_Seen[i] = false;
+    m_ActiveSlots[i] = -1;
+  }
+}
+
+void HandTable::Sync(const HandInfoMap& hands) {
+  for (int i = 0; i < MAX_HANDS; i++) {
+    m_Seen[i] = false;
+  }
+
+  m_OverflowCount = 0;
+  for (const auto& element : hands) {
+    int slotIdx = Find(element.first);
+    if (slotIdx < 0) {
+      for (int i = 0; i < MAX_HANDS; i++) {
+        if (!m_Occupied[i]) {
+          slotIdx = i;
+          m_Occupied[i] = true;
+          m_Slots[i].id = element.first;
+          break;
+        }
+      }
+    }
+    if (slotIdx < 0) {
+      m_OverflowCount++;
+      continue;
+    }
+    m_Seen[slotIdx] = true;
+    copyHand(*element.second, m_Slots[slotIdx]);
+  }
+
+  m_Count = 0;
+  for (int i = 0; i < MAX_HANDS; i++) {
+    m_Occupied[i] = m_Seen[i];
+    if (m_Occupied[i]) {
+      m_ActiveSlots[m_Count++] = i;
+    }
+  }
+}
+
+int HandTable::Find(int handId) const {
+  for (int i = 0; i < MAX_HANDS; i++) {
+    if (m_Occupied[i] && m_Slots[i].id == handId) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+Eigen::AlignedBox3f HandTable::BoundingBox(int slotIdx) const {
+  const Slot& slot = m_Slots[slotIdx];
+  Eigen::Vector3f min(slot.x[0], slot.y[0], slot.z[0]);
+  Eigen::Vector3f max = min;
+  for (int i = 1; i < NUM_POINTS; i++) {
+    min.x() = std::min(min.x(), slot.x[i]);
+    min.y() = std::min(min.y(), slot.y[i]);
+    min.z() = std::min(min.z(), slot.z[i]);
+    max.x() = std::max(max.x(), slot.x[i]);
+    max.y() = std::max(max.y(), slot.y[i]);
+    max.z() = std::max(max.z(), slot.z[i]);
+  }
+  return Eigen::AlignedBox3f(min, max);
+}
+
+const int* HandTable::BoneStartIndices() {
+  return boneIndices().start;
+}
+
+const int* HandTable::BoneEndIndices() {
+  return boneIndices().end;
+}
+
+void HandTable::copyHand(const HandInfo& hand, Slot& slot) {
+  slot.confidence = static_cast<float>(hand.GetConfidence());
+  for (int i = 0; i < NUM_POINTS; i++) {
+    const HandInfo::HandPoint& point = hand.GetHandPoint(i);
+    slot.x[i] = static_cast<float>(point.point.x());
+    slot.y[i] = static_cast<float>(point.point.y());
+    slot.z[i] = static_cast<float>(point.point.z());
+    slot.vx[i] = static_cast<float>(point.velocity.x());
+    slot.vy[i] = static_cast<float>(point.velocity.y());
+    slot.vz[i] = static_cast<float>(point.velocity.z());
+    slot.radius[i] = point.radius;
+    slot.isTip[i] = point.isTip ? 1 : 0;
+    slot.isExtended[i] = point.isExtended ? 1 : 0;
+  }
+}
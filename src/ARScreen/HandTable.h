@@ -0,0 +1,73 @@
+#pragma once
+
+#include "HandInfo.h"
+#include <cstdint>
+
+// A flat, fixed-capacity table of the tracked hands, keyed by Leap hand id.
+//
+// The per-point data of each hand is stored as separate contiguous float arrays
+// (structure of arrays), so interaction kernels can stream it through SIMD
+// registers.  Scene refreshes the table from its HandInfoMap once per update,
+// before the interaction queries, which then read the hands from here.  It
+// reuses its storage across frames and never allocates.  A hand keeps the same
+// slot for as long as it is tracked.
+class HandTable {
+public:
+  static const int MAX_HANDS = 8;
+  static const int NUM_POINTS = HandInfo::NUM_HAND_POINTS;
+  // Per-point arrays are padded to a multiple of 8 floats (one AVX register).
+  // The padding lanes hold zeros and are never referenced by the bone indices.
+  static const int POINT_CAPACITY = (NUM_POINTS + 7) & ~7;
+
+  struct Slot {
+    int id;
+    float confidence;
+    float x[POINT_CAPACITY];
+    float y[POINT_CAPACITY];
+    float z[POINT_CAPACITY];
+    float vx[POINT_CAPACITY];
+    float vy[POINT_CAPACITY];
+    float vz[POINT_CAPACITY];
+    float radius[POINT_CAPACITY];
+    uint8_t isTip[POINT_CAPACITY];
+    uint8_t isExtended[POINT_CAPACITY];
+  };
+
+  HandTable();
+
+  // Copies the current state of every tracked hand into the table.  Hands which
+  // are no longer in the map release their slots.  If there are more than
+  // MAX_HANDS hands, the extras are left out (see OverflowCount).
+  void Sync(const HandInfoMap& hands);
+
+  // Number of hands in the table, and their slot indices.
+  int Count() const { return m_Count; }
+  int ActiveSlotIndex(int i) const { return m_ActiveSlots[i]; }
+  const Slot& GetSlot(int slotIdx) const { return m_Slots[slotIdx]; }
+
+  // Returns the slot index holding the given hand id, or -1.
+  int Find(int handId) const;
+
+  // Axis-aligned box around all of the points (and hence all of the bones) of
+  // the hand in the given slot.
+  Eigen::AlignedBox3f BoundingBox(int slotIdx) const;
+
+  // Number of hands which did not fit in the table on the most recent Sync.
+  int OverflowCount() const { return m_OverflowCount; }
+
+  // The index pairs (start, end) of the bones of a hand, i.e. the 20 segments
+  // joining consecutive points of each finger.  Shared by all slots.
+  static const int NUM_BONES = 5 * HandInfo::BONES_PER_FINGER;
+  static const int* BoneStartIndices();
+  static const int* BoneEndIndices();
+
+private:
+  void copyHand(const HandInfo& hand, Slot& slot);
+
+  Slot m_Slots[MAX_HANDS];
+  bool m_Occupied[MAX_HANDS];
+  bool m_Seen[MAX_HANDS];
+  int m_ActiveSlots[MAX_HANDS];
+  int m_Count;
+  int m_OverflowCount;
+};
@@ -18,6 +18,12 @@ void ImagePassthrough::Init() {
 
   m_HandsShader = std::shared_ptr<Leap::GL::Shader>(new Leap::GL::Shader(Shaders::transformedVert, Shaders::imagesHandsFrag));
 
+  m_InstancedHandsShader = std::shared_ptr<Leap::GL::Shader>(new Leap::GL::Shader(Shaders::instancedVert, Shaders::imagesHandsFrag));
+
+  m_ShaderUniforms.Initialize(m_Shader.get(), imageUniformIds());
+  m_HandsShaderUniforms.Initialize(m_HandsShader.get(), imageUniformIds());
+  m_InstancedHandsShaderUniforms.Initialize(m_InstancedHandsShader.get(), imageUniformIds());
+
   m_Quad = std::shared_ptr<RectanglePrim>(new RectanglePrim());
   m_Quad->SetShader(m_Shader);
   m_Quad->Material().Uniform<TEXTURE_MAPPING_ENABLED>() = true;
@@ -31,36 +37,79 @@ void ImagePassthrough::Init() {
 void ImagePassthrough::Update(const Leap::ImageList& images) {
   assert(images.count() == NUM_CAMERAS);
   for (int i=0; i<images.count(); i++) {
-    updateImage(i, images[i]);
-    updateDistortion(i, images[i]);
+    const Leap::Image image = images[i];
+    updateImage(i, image.data(), image.width(), image.height(), image.bytesPerPixel());
+    updateDistortion(i, image.distortion(), image.distortionWidth(), image.distortionHeight());
+  }
+}
+
+void ImagePassthrough::Update(const std::vector<FrameRecording::Image>& images) {
+  // recordings made without images leave the passthrough as it was
+  const int count = std::min(static_cast<int>(images.size()), NUM_CAMERAS);
+  for (int i=0; i<count; i++) {
+    const FrameRecording::ImageHeader& header = images[i].header;
+    updateImage(i, images[i].data, header.width, header.height, header.bytesPerPixel);
+    updateDistortion(i, images[i].distortion, header.distortionWidth, header.distortionHeight);
   }
 }
 
 void ImagePassthrough::DrawStencilObject(PrimitiveBase* obj, RenderState& renderState, float viewWidth, float viewX, float viewHeight, float l00, float l11, float l03, float opacity) const {
+  drawStencil(obj, m_HandsShader, m_HandsShaderUniforms, renderState, viewWidth, viewX, viewHeight, l00, l11, l03, opacity);
+}
+
+void ImagePassthrough::DrawStencilInstances(InstancedBatch* batch, RenderState& renderState, float viewWidth, float viewX, float viewHeight, float l00, float l11, float l03, float opacity) const {
+  if (batch->InstanceCount() == 0) {
+    return;
+  }
+  drawStencil(batch, m_InstancedHandsShader, m_InstancedHandsShaderUniforms, renderState, viewWidth, viewX, viewHeight, l00, l11, l03, opacity);
+}
+
+ImagePassthrough::ImageShaderFrontend::UniformIds ImagePassthrough::imageUniformIds() {
+  return ImageShaderFrontend::UniformIds("gamma", "brightness", "use_texture", "texture", "distortion", "use_stencil", "use_color", "stencil_opacity",
+                                         "view_width", "view_height", "view_x", "l00", "l11", "l03", "opacity");
+}
+
+ImagePassthrough::ImageShaderFrontend::UniformMap ImagePassthrough::imageUniforms(float brightness) const {
+  ImageShaderFrontend::UniformMap uniforms;
+  uniforms.val<ImageUniform::GAMMA>() = m_Color ? 0.56f : 0.8f;
+  uniforms.val<ImageUniform::BRIGHTNESS>() = brightness;
+  uniforms.val<ImageUniform::TEXTURE_MAPPING_ENABLED>() = true;
+  uniforms.val<ImageUniform::TEXTURE_UNIT_INDEX>() = 0;
+  uniforms.val<ImageUniform::DISTORTION_UNIT_INDEX>() = 1;
+  uniforms.val<ImageUniform::USE_STENCIL>() = m_UseStencil;
+  uniforms.val<ImageUniform::USE_COLOR>() = m_Color;
+  uniforms.val<ImageUniform::STENCIL_OPACITY>() = 0.35f;
+  uniforms.val<ImageUniform::VIEW_WIDTH>() = 0.0f;
+  uniforms.val<ImageUniform::VIEW_HEIGHT>() = 0.0f;
+  uniforms.val<ImageUniform::VIEW_X>() = 0.0f;
+  uniforms.val<ImageUniform::L00>() = 0.0f;
+  uniforms.val<ImageUniform::L11>() = 0.0f;
+  uniforms.val<ImageUniform::L03>() = 0.0f;
+  uniforms.val<ImageUniform::OPACITY>() = 1.0f;
+  return uniforms;
+}
+
+void ImagePassthrough::drawStencil(PrimitiveBase* obj, const std::shared_ptr<Leap::GL::Shader>& shader, const ImageShaderFrontend& frontend, RenderState& renderState, float viewWidth, float viewX, float viewHeight, float l00, float l11, float l03, float opacity) const {
   if (m_ImageBytes[m_ActiveTexture] == 0 || m_DistortionBytes[m_ActiveTexture] == 0) {
     return;
   }
   if (opacity < 0.02f) {
     return;
   }
-  m_HandsShader->Bind();
-  m_HandsShader->UploadUniform<GL_FLOAT>("gamma", m_Color ? 0.56f : 0.8f);
-  m_HandsShader->UploadUniform<GL_FLOAT>("brightness", 1.0f);
-  m_HandsShader->UploadUniform<GL_BOOL>("use_texture", true);
-  m_HandsShader->UploadUniform<GL_SAMPLER_2D>("texture", 0);
-  m_HandsShader->UploadUniform<GL_SAMPLER_2D>("distortion", 1);
-  m_HandsShader->UploadUniform<GL_BOOL>("use_stencil", m_UseStencil);
-  m_HandsShader->UploadUniform<GL_BOOL>("use_color", m_Color);
-  m_HandsShader->UploadUniform<GL_FLOAT>("view_width", viewWidth);
-  m_HandsShader->UploadUniform<GL_FLOAT>("view_height", viewHeight);
-  m_HandsShader->UploadUniform<GL_FLOAT>("view_x", viewX);
-  m_HandsShader->UploadUniform<GL_FLOAT>("l00", l00);
-  m_HandsShader->UploadUniform<GL_FLOAT>("l11", l11);
-  m_HandsShader->UploadUniform<GL_FLOAT>("l03", l03);
-  m_HandsShader->UploadUniform<GL_FLOAT>("opacity", opacity);
-  m_HandsShader->Unbind();
-
-  obj->SetShader(m_HandsShader);
+  ImageShaderFrontend::UniformMap uniforms = imageUniforms(1.0f);
+  uniforms.val<ImageUniform::VIEW_WIDTH>() = viewWidth;
+  uniforms.val<ImageUniform::VIEW_HEIGHT>() = viewHeight;
+  uniforms.val<ImageUniform::VIEW_X>() = viewX;
+  uniforms.val<ImageUniform::L00>() = l00;
+  uniforms.val<ImageUniform::L11>() = l11;
+  uniforms.val<ImageUniform::L03>() = l03;
+  uniforms.val<ImageUniform::OPACITY>() = opacity;
+  // Values that are the same as for the previous hand part aren't uploaded again.
+  shader->Bind();
+  frontend.UploadUniforms(uniforms);
+  shader->Unbind();
+
+  obj->SetShader(shader);
 
   m_Textures[m_ActiveTexture]->Bind(0);
   m_Distortion[m_ActiveTexture]->Bind(1);
@@ -74,14 +123,7 @@ void ImagePassthrough::Draw(RenderState& renderState, float opacity) const {
     return;
   }
   m_Shader->Bind();
-  m_Shader->UploadUniform<GL_FLOAT>("gamma", m_Color ? 0.56f : 0.8f);
-  m_Shader->UploadUniform<GL_FLOAT>("brightness", opacity);
-  m_Shader->UploadUniform<GL_BOOL>("use_texture", true);
-  m_Shader->UploadUniform<GL_SAMPLER_2D>("texture", 0);
-  m_Shader->UploadUniform<GL_SAMPLER_2D>("distortion", 1);
-  m_Shader->UploadUniform<GL_BOOL>("use_stencil", m_UseStencil);
-  m_Shader->UploadUniform<GL_BOOL>("use_color", m_Color);
-  m_Shader->UploadUniform<GL_FLOAT>("stencil_opacity", 0.35f);
+  m_ShaderUniforms.UploadUniforms(imageUniforms(opacity));
   m_Shader->Unbind();
 
   m_Quad->SetTexture(m_Textures[m_ActiveTexture]);
@@ -93,15 +135,11 @@ void ImagePassthrough::Draw(RenderState& renderState, float opacity) const {
   m_Textures[m_ActiveTexture]->Unbind();
 }
 
-void ImagePassthrough::updateImage(int idx, const Leap::Image& image) {
-  GLenum format = (image.width() == 640) ? GL_LUMINANCE : GL_RGBA;
+void ImagePassthrough::updateImage(int idx, const unsigned char* data, int width, int height, int bytesPerPixel) {
+  GLenum format = (width == 640) ? GL_LUMINANCE : GL_RGBA;
   m_Color = (format == GL_RGBA);
 
   std::shared_ptr<Leap::GL::Texture2>& tex = m_Textures[idx];
-  const unsigned char* data = image.data();
-  const int width = image.width();
-  const int height = image.height();
-  const int bytesPerPixel = image.bytesPerPixel();
   const size_t numBytes = static_cast<size_t>(width * height * bytesPerPixel);
   Leap::GL::Texture2PixelData pixelData(format, GL_UNSIGNED_BYTE, data, numBytes);
   if (!tex || numBytes != m_ImageBytes[idx]) {
@@ -119,11 +157,10 @@ void ImagePassthrough::updateImage(int idx, const Leap::Image& image) {
   }
 }
 
-void ImagePassthrough::updateDistortion(int idx, const Leap::Image& image) {
+void ImagePassthrough::updateDistortion(int idx, const float* data, int distortionWidth, int distortionHeight) {
   std::shared_ptr<Leap::GL::Texture2>& distortion = m_Distortion[idx];
-  const float* data = image.distortion();
-  const int width = image.distortionWidth()/2;
-  const int height = image.distortionHeight();
+  const int width = distortionWidth/2;
+  const int height = distortionHeight;
   const int bytesPerPixel = 2 * sizeof(float); // XY per pixel
   const size_t numBytes = static_cast<size_t>(width * height * bytesPerPixel);
   Leap::GL::Texture2PixelData pixelData(GL_RG, GL_FLOAT, data, numBytes);
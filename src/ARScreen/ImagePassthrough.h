@@ -1,7 +1,10 @@
 #pragma once
 
+#include "Primitives/InstancedBatch.h"
 #include "Primitives/Primitives.h"
+#include "Leap/GL/ShaderFrontend.h"
 #include "Leap/GL/Texture2.h"
+#include "LeapListener/FrameRecording.h"
 #include "LeapListener/LeapListener.h"
 
 class ImagePassthrough {
@@ -10,18 +13,70 @@ public:
   void Init();
   void SetActiveTexture(int activeTexture) { m_ActiveTexture = activeTexture; }
   void Update(const Leap::ImageList& images);
+  void Update(const std::vector<FrameRecording::Image>& images);
   void SetUseStencil(bool use) { m_UseStencil = use; }
   void DrawStencilObject(PrimitiveBase* obj, RenderState& renderState, float viewWidth, float viewX, float viewHeight, float l00, float l11, float l03, float opacity) const;
+  // As DrawStencilObject, but draws all of the batch's instances at once.
+  void DrawStencilInstances(InstancedBatch* batch, RenderState& renderState, float viewWidth, float viewX, float viewHeight, float l00, float l11, float l03, float opacity) const;
   void Draw(RenderState& renderState, float opacity = 1.0f) const;
 
 private:
 
+  // The uniforms of imagesFrag and imagesHandsFrag.  Each shader only has some of them, and the
+  // others are ignored when uploading.
+  enum class ImageUniform {
+    GAMMA,
+    BRIGHTNESS,
+    TEXTURE_MAPPING_ENABLED,
+    TEXTURE_UNIT_INDEX,
+    DISTORTION_UNIT_INDEX,
+    USE_STENCIL,
+    USE_COLOR,
+    STENCIL_OPACITY,
+    VIEW_WIDTH,
+    VIEW_HEIGHT,
+    VIEW_X,
+    L00,
+    L11,
+    L03,
+    OPACITY
+  };
+
+  template <ImageUniform NAME_, GLenum GL_TYPE_, typename CppType_>
+  using ImageShaderUniform = Leap::GL::Uniform<ImageUniform,NAME_,GL_TYPE_,CppType_>;
+
+  typedef Leap::GL::ShaderFrontend<ImageUniform,
+                                   ImageShaderUniform<ImageUniform::GAMMA,GL_FLOAT,float>,
+                                   ImageShaderUniform<ImageUniform::BRIGHTNESS,GL_FLOAT,float>,
+                                   ImageShaderUniform<ImageUniform::TEXTURE_MAPPING_ENABLED,GL_BOOL,GLint>,
+                                   ImageShaderUniform<ImageUniform::TEXTURE_UNIT_INDEX,GL_SAMPLER_2D,GLint>,
+                                   ImageShaderUniform<ImageUniform::DISTORTION_UNIT_INDEX,GL_SAMPLER_2D,GLint>,
+                                   ImageShaderUniform<ImageUniform::USE_STENCIL,GL_BOOL,GLint>,
+                                   ImageShaderUniform<ImageUniform::USE_COLOR,GL_BOOL,GLint>,
+                                   ImageShaderUniform<ImageUniform::STENCIL_OPACITY,GL_FLOAT,float>,
+                                   ImageShaderUniform<ImageUniform::VIEW_WIDTH,GL_FLOAT,float>,
+                                   ImageShaderUniform<ImageUniform::VIEW_HEIGHT,GL_FLOAT,float>,
+                                   ImageShaderUniform<ImageUniform::VIEW_X,GL_FLOAT,float>,
+                                   ImageShaderUniform<ImageUniform::L00,GL_FLOAT,float>,
+                                   ImageShaderUniform<ImageUniform::L11,GL_FLOAT,float>,
+                                   ImageShaderUniform<ImageUniform::L03,GL_FLOAT,float>,
+                                   ImageShaderUniform<ImageUniform::OPACITY,GL_FLOAT,float>> ImageShaderFrontend;
+
+  static ImageShaderFrontend::UniformIds imageUniformIds();
+  ImageShaderFrontend::UniformMap imageUniforms(float brightness) const;
+  void drawStencil(PrimitiveBase* obj, const std::shared_ptr<Leap::GL::Shader>& shader, const ImageShaderFrontend& frontend, RenderState& renderState, float viewWidth, float viewX, float viewHeight, float l00, float l11, float l03, float opacity) const;
+
   std::shared_ptr<Leap::GL::Shader> m_Shader;
   std::shared_ptr<Leap::GL::Shader> m_HandsShader;
+  std::shared_ptr<Leap::GL::Shader> m_InstancedHandsShader;
+  // The uniform locations of the above shaders, looked up once in Init.
+  ImageShaderFrontend m_ShaderUniforms;
+  ImageShaderFrontend m_HandsShaderUniforms;
+  ImageShaderFrontend m_InstancedHandsShaderUniforms;
   std::shared_ptr<RectanglePrim> m_Quad;
 
-  void updateImage(int idx, const Leap::Image& image);
-  void updateDistortion(int idx, const Leap::Image& image);
+  void updateImage(int idx, const unsigned char* data, int width, int height, int bytesPerPixel);
+  void updateDistortion(int idx, const float* data, int distortionWidth, int distortionHeight);
 
   static const int NUM_CAMERAS = 2;
 
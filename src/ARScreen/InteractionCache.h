@@ -0,0 +1,70 @@
+#pragma once
+
+#include "HandInfo.h"
+#include <vector>
+
+class FakeWindow;
+
+// The hand intersections for one frame, computed once by Scene::Update after the
+// tracked hands have been updated.  The interaction logic and every render pass
+// (both eyes) read from here instead of re-intersecting the hands.
+//
+// Storage is reused from frame to frame: Clear only resets the counts.
+class InteractionCache {
+public:
+  struct WindowHits {
+    FakeWindow* window;
+    // one entry per hand which intersects the window
+    std::vector<HandInfo::IntersectionVector> perHand;
+  };
+
+  struct HandButtons {
+    bool calendar;
+    bool record;
+  };
+
+  InteractionCache() : m_NumWindows(0) { }
+
+  void Clear() {
+    m_NumWindows = 0;
+    m_NewsFeed.clear();
+    m_Buttons.clear();
+  }
+
+  // Returns a cleared entry for the window, reusing an old entry's storage.
+  WindowHits& AddWindow(FakeWindow* window) {
+    if (m_NumWindows == m_Windows.size()) {
+      m_Windows.push_back(WindowHits());
+    }
+    WindowHits& hits = m_Windows[m_NumWindows++];
+    hits.window = window;
+    hits.perHand.clear();
+    return hits;
+  }
+
+  // Undoes the most recent AddWindow, e.g. if no hand turned out to intersect it.
+  void PopWindow() { m_NumWindows--; }
+
+  // Returns the hits for the given window, or nullptr if no hand intersects it.
+  const WindowHits* FindWindow(const FakeWindow* window) const {
+    for (size_t i = 0; i < m_NumWindows; i++) {
+      if (m_Windows[i].window == window) {
+        return &m_Windows[i];
+      }
+    }
+    return nullptr;
+  }
+
+  HandInfo::IntersectionVector& NewsFeed() { return m_NewsFeed; }
+  const HandInfo::IntersectionVector& NewsFeed() const { return m_NewsFeed; }
+
+  // Which of the buttons each hand is touching, in HandTable order (HandTable::ActiveSlotIndex).
+  std::vector<HandButtons>& Buttons() { return m_Buttons; }
+  const std::vector<HandButtons>& Buttons() const { return m_Buttons; }
+
+private:
+  std::vector<WindowHits> m_Windows;
+  size_t m_NumWindows;
+  HandInfo::IntersectionVector m_NewsFeed;
+  std::vector<HandButtons> m_Buttons;
+};
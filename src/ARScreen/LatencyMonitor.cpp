@@ -0,0 +1,45 @@
+#include "stdafx.h"
+#include "LatencyMonitor.h"
+
+#include <algorithm>
+
+namespace {
+
+// Beyond this the extrapolated hands visibly overshoot on quick stops.
+const double MAX_HORIZON = 0.05;
+
+// Samples outside this range come from a clock discontinuity (reconnecting,
+// a stale frame after losing focus) rather than from the pipeline.
+const double MAX_PLAUSIBLE_LATENCY = 0.5;
+
+// Weight of each new sample in the moving average.
+const double AVERAGE_WEIGHT = 0.05;
+
+}
+
+LatencyMonitor::LatencyMonitor(double fixedHorizon) :
+  m_FixedHorizon(fixedHorizon),
+  m_AverageLatency(0.0),
+  m_Stats("latency")
+{ }
+
+void LatencyMonitor::AddSample(double seconds) {
+  if (seconds < 0.0 || seconds > MAX_PLAUSIBLE_LATENCY) {
+    return;
+  }
+  if (m_Stats.Count() == 0) {
+    m_AverageLatency = seconds;
+  } else {
+    m_AverageLatency += AVERAGE_WEIGHT * (seconds - m_AverageLatency);
+  }
+  m_Stats.AddSample(seconds);
+}
+
+double LatencyMonitor::Horizon() const {
+  const double horizon = IsAutoTuned() ? m_AverageLatency : m_FixedHorizon;
+  return std::max(0.0, std::min(MAX_HORIZON, horizon));
+}
+
+double LatencyMonitor::MaxHorizon() {
+  return MAX_HORIZON;
+}
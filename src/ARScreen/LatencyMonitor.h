@@ -0,0 +1,32 @@
+#pragma once
+
+#include "utility/TimingStats.h"
+
+// Tracks the measured pipeline latency, from the time a tracking frame was
+// sampled by the device to the buffer swap which displayed it, and chooses how
+// far ahead to extrapolate the hands so that they line up with the real ones
+// at display time.
+//
+// The horizon is either fixed, or (when auto-tuned) follows a moving average of
+// the measured latency.  Either way it is clamped, since linear extrapolation
+// overshoots badly when the hands change direction.
+class LatencyMonitor {
+public:
+  // A negative fixed horizon selects auto-tuning.
+  explicit LatencyMonitor(double fixedHorizon = -1.0);
+
+  void AddSample(double seconds);
+
+  bool IsAutoTuned() const { return m_FixedHorizon < 0.0; }
+  // Seconds to extrapolate the hands by, in [0, MaxHorizon()].
+  double Horizon() const;
+  double AverageLatency() const { return m_AverageLatency; }
+  const TimingStats& Stats() const { return m_Stats; }
+
+  static double MaxHorizon();
+
+private:
+  double m_FixedHorizon;
+  double m_AverageLatency;
+  TimingStats m_Stats;
+};
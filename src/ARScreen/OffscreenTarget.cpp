@@ -0,0 +1,66 @@
+#include "stdafx.h"
+#include "OffscreenTarget.h"
+
+OffscreenTarget::OffscreenTarget() :
+  m_Width(0),
+  m_Height(0),
+  m_Framebuffer(0),
+  m_ColorBuffer(0),
+  m_DepthStencilBuffer(0)
+{ }
+
+OffscreenTarget::~OffscreenTarget() {
+  if (m_Context) {
+    m_Context->setActive(true);
+    glDeleteFramebuffers(1, &m_Framebuffer);
+    glDeleteRenderbuffers(1, &m_ColorBuffer);
+    glDeleteRenderbuffers(1, &m_DepthStencilBuffer);
+  }
+}
+
+void OffscreenTarget::Init(int width, int height) {
+  m_Width = width;
+  m_Height = height;
+
+  sf::ContextSettings settings;
+  settings.depthBits = 24;
+  settings.stencilBits = 8;
+  settings.antialiasingLevel = 0;
+  m_Context = std::unique_ptr<sf::Context>(new sf::Context(settings, width, height));
+  if (!m_Context->setActive(true)) {
+    throw std::runtime_error("Unable to activate offscreen GL context");
+  }
+  if (glewInit() != GLEW_OK) {
+    throw std::runtime_error("Unable to initialize glew");
+  }
+  if (!GLEW_VERSION_3_0 && !GLEW_ARB_framebuffer_object) {
+    throw std::runtime_error("Offscreen rendering requires framebuffer object support");
+  }
+
+  glGenRenderbuffers(1, &m_ColorBuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, m_ColorBuffer);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+  glGenRenderbuffers(1, &m_DepthStencilBuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, m_DepthStencilBuffer);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glGenFramebuffers(1, &m_Framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorBuffer);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthStencilBuffer);
+  const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    throw std::runtime_error("Offscreen framebuffer is incomplete");
+  }
+  glViewport(0, 0, width, height);
+}
+
+void OffscreenTarget::Bind() const {
+  glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+}
+
+void OffscreenTarget::Unbind() const {
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
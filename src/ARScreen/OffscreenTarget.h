@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Leap/GL/GLHeaders.h"
+#include <SFML/Window/Context.hpp>
+#include <memory>
+
+// A GL context with no window, rendering into a framebuffer object.  Used for
+// headless runs, e.g. on machines with no display, under a software renderer
+// such as Mesa's llvmpipe.
+class OffscreenTarget {
+public:
+  OffscreenTarget();
+  ~OffscreenTarget();
+
+  // Creates the context and framebuffer, and makes both current.  glewInit must
+  // be called after the context exists, so this takes care of it too.
+  void Init(int width, int height);
+
+  int Width() const { return m_Width; }
+  int Height() const { return m_Height; }
+
+  void Bind() const;
+  void Unbind() const;
+
+private:
+  OffscreenTarget(const OffscreenTarget&) = delete;
+  OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+  std::unique_ptr<sf::Context> m_Context;
+  int m_Width;
+  int m_Height;
+  GLuint m_Framebuffer;
+  GLuint m_ColorBuffer;
+  GLuint m_DepthStencilBuffer;
+};
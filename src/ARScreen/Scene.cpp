@@ -1,17 +1,23 @@
 #include "stdafx.h"
 #include "Scene.h"
 #include "Leap/GL/Projection.h"
+#include "Leap/GL/StateCache.h"
 #include "WindowManager.h"
 #include "Globals.h"
 
 Scene::Scene() :
+  m_PredictionHorizon(0.0),
+  m_MaxFramesPerUpdate(0),
+  m_CoalescedFrameCount(0),
+  m_ValidateIntersections(false),
+  m_BatchIntersections(NUM_UI_TARGETS * HandTable::MAX_HANDS * HandTable::NUM_BONES),
   m_ScreenPositionSmoother(Eigen::Vector3d::Zero()),
   m_ScreenRotationSmoother(Eigen::Matrix3d::Identity()),
   m_CalendarOpacity(0.0f),
   m_ButtonAnimation(1.0f),
+  m_ImageOpacity(1.0f),
   m_ActivationGesture(false),
   m_DeactivationGesture(false),
-  m_ImageOpacity(1.0f),
   m_ScrollVel(0.0)
 {
   m_ScreenPositionSmoother.SetSmoothStrength(0.9f);
@@ -42,6 +48,9 @@ void Scene::Init() {
   m_IntersectionDisk = std::shared_ptr<Disk>(new Disk());
   m_IntersectionDisk->Material().Uniform<AMBIENT_LIGHTING_PROPORTION>() = 1.0f;
 
+  m_NewsFeedIntersectionDisks = std::shared_ptr<InstancedBatch>(new InstancedBatch());
+  m_NewsFeedIntersectionDisks->Material().Uniform<AMBIENT_LIGHTING_PROPORTION>() = 1.0f;
+
   createUI();
 
   createNewsFeed();
@@ -55,7 +64,14 @@ void Scene::SetInputTransform(const EigenTypes::Matrix3x3& rotation, const Eigen
 }
 
 void Scene::Update(const std::deque<Leap::Frame>& frames) {
-  for (size_t i = 0; i < frames.size(); i++) {
+  // When coalescing a backlog, the oldest frames are skipped, and the first
+  // frame processed advances the smoothers over their time as well.
+  size_t firstFrame = 0;
+  if (m_MaxFramesPerUpdate > 0 && frames.size() > m_MaxFramesPerUpdate) {
+    firstFrame = frames.size() - m_MaxFramesPerUpdate;
+    m_CoalescedFrameCount += firstFrame;
+  }
+  for (size_t i = firstFrame; i < frames.size(); i++) {
     m_PrevFrame = m_CurFrame;
     const double prevTimeSeconds = timestampToSeconds(m_PrevFrame.timestamp());
     m_CurFrame = frames[i];
@@ -65,33 +81,28 @@ void Scene::Update(const std::deque<Leap::Frame>& frames) {
       continue;
     }
 
-    updateTrackedHands(leapDeltaTime);
-
-    const double scale = m_InputRotation.col(0).norm();
-
-    const Leap::TrackedQuad quad = m_CurFrame.trackedQuad();
-    if (quad.isValid() && quad.visible()) {
-      // ratio of tracked quad to monitor dimensions
-      const double horizScale = 1.143;
-      const double vertScale = 1.286;
-
-      Globals::haveScreen = true;
-      Globals::screenWidth = horizScale * scale * quad.width();
-      Globals::screenHeight = vertScale * scale * quad.height();
-      m_ScreenPositionSmoother.SetGoal(m_InputRotation * quad.position().toVector3<Eigen::Vector3d>() + m_InputTranslation);
-      m_ScreenRotationSmoother.SetGoal(m_InputRotation * toEigen(quad.orientation()));
-    }
-    m_ScreenPositionSmoother.Update(leapDeltaTime);
-    m_ScreenRotationSmoother.Update(leapDeltaTime);
+    const int numSteps = i == firstFrame ? static_cast<int>(firstFrame) + 1 : 1;
+    updateTrackedHands(leapDeltaTime, numSteps);
+    updateTrackedQuad(m_CurFrame);
+    m_ScreenPositionSmoother.Update(leapDeltaTime / numSteps, numSteps);
+    m_ScreenRotationSmoother.Update(leapDeltaTime / numSteps, numSteps);
+  }
+  for (auto& it : m_TrackedHands) {
+    it.second->SetPredictionHorizon(m_PredictionHorizon);
   }
   Globals::screenPos = m_ScreenPositionSmoother.Value();
   Globals::screenBasis = m_ScreenRotationSmoother.Value();
   const double prevTimeSeconds = timestampToSeconds(m_PrevFrame.timestamp());
   const double curTimeSeconds = timestampToSeconds(m_CurFrame.timestamp());
   const float leapDeltaTime = static_cast<float>(curTimeSeconds - prevTimeSeconds);
+  layoutNewsFeed();
+  updateInteractionCache();
   leapInteract(leapDeltaTime);
+  updateButtons();
 
-  if (!frames.empty()) {
+  if (m_Replay) {
+    m_ImagePassthrough->Update(m_Replay->LatestImages());
+  } else if (!frames.empty()) {
     m_ImagePassthrough->Update(frames.back().images());
   }
 
@@ -105,9 +116,53 @@ void Scene::Update(const std::deque<Leap::Frame>& frames) {
   m_CalendarOpacity.Update((Globals::timeBetweenFrames.count()));
   m_ButtonAnimation.Update((Globals::timeBetweenFrames.count()));
   m_ImageOpacity.Update((Globals::timeBetweenFrames.count()));
+
+  compileRenderLists();
+}
+
+void Scene::updateTrackedQuad(const Leap::Frame& frame) {
+  bool visible = false;
+  double width = 0, height = 0;
+  Eigen::Vector3d position;
+  Eigen::Matrix3d orientation;
+  if (m_Replay) {
+    const FrameRecording::TrackedQuad* quad = m_Replay->TrackedQuadForFrame(frame);
+    if (quad && quad->valid && quad->visible) {
+      visible = true;
+      width = quad->width;
+      height = quad->height;
+      position = Eigen::Map<const Eigen::Vector3f>(quad->position).cast<double>();
+      orientation = Eigen::Map<const Eigen::Matrix3f>(quad->orientation).cast<double>();
+    }
+  } else {
+    const Leap::TrackedQuad quad = frame.trackedQuad();
+    if (quad.isValid() && quad.visible()) {
+      visible = true;
+      width = quad.width();
+      height = quad.height();
+      position = quad.position().toVector3<Eigen::Vector3d>();
+      orientation = toEigen(quad.orientation());
+    }
+  }
+
+  if (visible) {
+    // ratio of tracked quad to monitor dimensions
+    const double horizScale = 1.143;
+    const double vertScale = 1.286;
+    const double scale = m_InputRotation.col(0).norm();
+
+    Globals::haveScreen = true;
+    Globals::screenWidth = horizScale * scale * width;
+    Globals::screenHeight = vertScale * scale * height;
+    m_ScreenPositionSmoother.SetGoal(m_InputRotation * position + m_InputTranslation);
+    m_ScreenRotationSmoother.SetGoal(m_InputRotation * orientation);
+  }
 }
 
 void Scene::Render(const Eigen::Matrix4f& proj, const Eigen::Matrix4f& view, int eyeIdx) const {
+  // Every primitive unbinds its shader and textures when done, so leave them bound until the
+  // end, in case the next primitive binds them again.
+  Leap::GL::StateCache::DeferredUnbindScope deferUnbinds;
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   m_Renderer.ProjectionMatrix() = proj.cast<double>();
@@ -123,11 +178,11 @@ void Scene::Render(const Eigen::Matrix4f& proj, const Eigen::Matrix4f& view, int
   m_Renderer.GetModelView().Matrix() = view.cast<double>();
 
   glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA, GL_ONE);
-  drawWindows();
+  m_WindowList.Draw(m_Renderer);
   drawFakeMouse();
-  drawUI();
-  drawNewsFeed();
-  drawPeople();
+  m_UIList.Draw(m_Renderer);
+  m_NewsFeedList.Draw(m_Renderer);
+  m_PeopleList.Draw(m_Renderer);
 
   m_Renderer.GetModelView().Matrix().setIdentity();
   glDisable(GL_DEPTH_TEST);
@@ -144,7 +199,7 @@ void Scene::Render(const Eigen::Matrix4f& proj, const Eigen::Matrix4f& view, int
   glDepthMask(GL_TRUE);
 }
 
-void Scene::updateTrackedHands(float deltaTime) {
+void Scene::updateTrackedHands(float deltaTime, int numSteps) {
   const double curTimeSeconds = timestampToSeconds(m_CurFrame.timestamp());
 
   // update
@@ -156,14 +211,14 @@ void Scene::updateTrackedHands(float deltaTime) {
     if (itr == m_TrackedHands.end()) {
       m_TrackedHands[id] = std::shared_ptr<HandInfo>(new HandInfo());
     }
-    m_TrackedHands[id]->Update(hands[i], deltaTime, m_InputRotation, m_InputTranslation);
+    m_TrackedHands[id]->Update(hands[i], deltaTime, m_InputRotation, m_InputTranslation, numSteps);
   }
 
   // update hands that weren't matched this frame
   for (auto& element : m_TrackedHands) {
     HandInfo& trackedHand = *element.second;
     if (trackedHand.GetLastUpdateTime() != curTimeSeconds) {
-      trackedHand.UpdateWithoutHand(deltaTime);
+      trackedHand.UpdateWithoutHand(deltaTime, numSteps);
     }
   }
 
@@ -190,19 +245,17 @@ void Scene::updateTrackedHands(float deltaTime) {
 void Scene::leapInteract(float deltaTime) {
   AutowiredFast<WindowManager> manager;
   if (manager) {
+    static const std::vector<HandInfo::IntersectionVector> noIntersections;
     for (auto& it : manager->m_Windows) {
       FakeWindow& wind = *it.second;
-      wind.Interact(*(manager->m_WindowTransform), m_TrackedHands, deltaTime);
+      const InteractionCache::WindowHits* hits = m_InteractionCache.FindWindow(&wind);
+      wind.Interact(*(manager->m_WindowTransform), hits ? hits->perHand : noIntersections, deltaTime);
     }
   }
 
   double scrollVel = 0;
-  for (const auto& it : m_TrackedHands) {
-    const HandInfo& trackedHand = *it.second;
-    HandInfo::IntersectionVector intersections = trackedHand.IntersectRectangle(*m_NewsFeedRect);
-    for (const auto& intersection : intersections) {
-      scrollVel += 0.25 * intersection.velocity.y();
-    }
+  for (const auto& intersection : m_InteractionCache.NewsFeed()) {
+    scrollVel += 0.25 * intersection.velocity.y();
   }
   if (std::fabs(scrollVel) > 0.01) {
     m_ScrollVel.SetSmoothStrength(0.1f);
@@ -304,21 +357,232 @@ void Scene::drawFakeMouse() const {
   }
 }
 
-void Scene::drawWindows() const {
+void Scene::compileRenderLists() {
+  // The primitives below are shared between several draws (e.g. one icon disk for
+  // every icon), so each compile function positions and colors them, then adds them
+  // to its list, which records that state.
+  m_WindowList.Begin();
+  compileWindows();
+  m_WindowList.End();
+
+  m_UIList.Begin();
+  compileUI();
+  m_UIList.End();
+
+  m_NewsFeedList.Begin();
+  compileNewsFeed();
+  m_NewsFeedList.End();
+
+  m_PeopleList.Begin();
+  compilePeople();
+  m_PeopleList.End();
+}
+
+void Scene::compileWindows() {
+  // each window's intersection disks are drawn right after it, so that they blend
+  // over it just as they would if the windows were drawn directly
   AutowiredFast<WindowManager> manager;
   if (manager) {
     for (const auto& it : manager->m_Windows) {
-      PrimitiveBase::DrawSceneGraph(*it.second->m_Texture, m_Renderer);
-      for (const auto& it2 : m_TrackedHands) {
-        const HandInfo& trackedHand = *it2.second;
-        HandInfo::IntersectionVector intersections = trackedHand.IntersectRectangle(*it.second->m_Texture);
+      m_WindowList.Add(*it.second->m_Texture);
+      const InteractionCache::WindowHits* hits = m_InteractionCache.FindWindow(it.second.get());
+      if (!hits) {
+        continue;
+      }
+      for (const auto& intersections : hits->perHand) {
         for (const auto& intersection : intersections) {
           m_IntersectionDisk->Translation() = intersection.point;
           m_IntersectionDisk->SetRadius(1.25*intersection.radius);
           m_IntersectionDisk->Material().Uniform<AMBIENT_LIGHT_COLOR>() = makeIntersectionDiskColor(intersection.confidence);
           m_IntersectionDisk->LinearTransformation() = Eigen::Matrix3d::Identity();
-          PrimitiveBase::DrawSceneGraph(*m_IntersectionDisk, m_Renderer);
+          m_WindowList.Add(*m_IntersectionDisk);
+        }
+      }
+    }
+  }
+}
+
+void Scene::queryWindowCandidates(const WindowManager& manager) {
+  // a bone can only cross a window's quad where the two bounding boxes overlap;
+  // the margin guards against rounding in the flat (zero thickness) window boxes
+  static const double MARGIN = 1.0;
+  m_WindowCandidates.resize(m_HandTable.Count());
+  for (int i = 0; i < m_HandTable.Count(); i++) {
+    HandWindowCandidates& candidates = m_WindowCandidates[i];
+    candidates.slotIdx = m_HandTable.ActiveSlotIndex(i);
+    candidates.hand = m_TrackedHands.at(m_HandTable.GetSlot(candidates.slotIdx).id).get();
+    candidates.windows.clear();
+    Eigen::AlignedBox3d bounds = m_HandTable.BoundingBox(candidates.slotIdx).cast<double>();
+    bounds.min().array() -= MARGIN;
+    bounds.max().array() += MARGIN;
+    manager.m_Broadphase.Query(bounds, candidates.windows);
+  }
+}
+
+void Scene::layoutNewsFeed() {
+  const double feedHeight = 250.0;
+  const double feedWidth = 350.0;
+
+  m_NewsFeedRect->SetSize(Eigen::Vector2d(feedWidth, feedHeight));
+  m_NewsFeedRect->Translation() << -350, 50 + Globals::globalHeightOffset, 250 + Globals::globalZOffset;
+  m_NewsFeedRect->LinearTransformation() = faceCameraMatrix(m_NewsFeedRect->Translation(), Globals::userPos, false);
+}
+
+void Scene::positionIconDisk(int slot) const {
+  const double spacing = 2.25 * m_IconDisk->Radius();
+  const double x = 350;
+  const double y = 100 + Globals::globalHeightOffset - slot * spacing;
+  const double z = 175 + Globals::globalZOffset;
+  m_IconDisk->Translation() << x, y, z;
+  m_IconDisk->LinearTransformation() = faceCameraMatrix(m_IconDisk->Translation(), Globals::userPos, false);
+}
+
+void Scene::updateInteractionCache() {
+  m_InteractionCache.Clear();
+  m_HandTable.Sync(m_TrackedHands);
+
+  AutowiredFast<WindowManager> manager;
+  if (manager) {
+    queryWindowCandidates(*manager);
+    // Only windows which are some hand's candidate are visited.  Sorting groups each
+    // window's hands together, in m_WindowCandidates order.
+    m_CandidatePairs.clear();
+    for (size_t i = 0; i < m_WindowCandidates.size(); i++) {
+      for (FakeWindow* window : m_WindowCandidates[i].windows) {
+        m_CandidatePairs.emplace_back(window, i);
+      }
+    }
+    std::sort(m_CandidatePairs.begin(), m_CandidatePairs.end());
+    for (size_t begin = 0, end = 0; begin < m_CandidatePairs.size(); begin = end) {
+      FakeWindow* window = m_CandidatePairs[begin].first;
+      InteractionCache::WindowHits& hits = m_InteractionCache.AddWindow(window);
+      const IntersectionTarget target = IntersectionTarget::FromRectangle(*window->m_Texture);
+      for (end = begin; end < m_CandidatePairs.size() && m_CandidatePairs[end].first == window; end++) {
+        const HandWindowCandidates& candidates = m_WindowCandidates[m_CandidatePairs[end].second];
+        const HandTable::Slot& slot = m_HandTable.GetSlot(candidates.slotIdx);
+        const size_t count = IntersectHandBatch(slot, target, 0, m_BatchIntersections.data(), m_BatchIntersections.size());
+        if (m_ValidateIntersections) {
+          validateIntersections(slot, target, m_BatchIntersections.data(), count, candidates.hand->IntersectRectangle(*window->m_Texture));
+        }
+        if (count > 0) {
+          hits.perHand.emplace_back();
+          AppendIntersections(m_BatchIntersections.data(), count, hits.perHand.back());
+        }
+      }
+      if (hits.perHand.empty()) {
+        m_InteractionCache.PopWindow();
+      }
+    }
+  }
+
+  // The news feed and the two icons are intersected with every hand in one batch.
+  // The icon disk is moved between the icons' slots, so each disk target is taken
+  // right after positioning it.
+  IntersectionTarget uiTargets[NUM_UI_TARGETS];
+  uiTargets[NEWS_FEED_TARGET] = IntersectionTarget::FromRectangle(*m_NewsFeedRect);
+  positionIconDisk(CALENDAR_ICON_SLOT);
+  uiTargets[CALENDAR_TARGET] = IntersectionTarget::FromDisk(*m_IconDisk);
+  positionIconDisk(RECORD_ICON_SLOT);
+  uiTargets[RECORD_TARGET] = IntersectionTarget::FromDisk(*m_IconDisk);
+  const size_t count = IntersectHandsBatch(m_HandTable, uiTargets, NUM_UI_TARGETS, m_BatchIntersections.data(), m_BatchIntersections.size());
+
+  HandInfo::IntersectionVector& newsFeed = m_InteractionCache.NewsFeed();
+  std::vector<InteractionCache::HandButtons>& buttons = m_InteractionCache.Buttons();
+  buttons.assign(m_HandTable.Count(), InteractionCache::HandButtons{false, false});
+  // Results are ordered by target, then by hand, so each hand's run is contiguous.
+  for (size_t begin = 0, end = 0; begin < count; begin = end) {
+    const BatchIntersection& first = m_BatchIntersections[begin];
+    for (end = begin; end < count && m_BatchIntersections[end].targetIdx == first.targetIdx && m_BatchIntersections[end].handId == first.handId; end++) { }
+    int handIdx = 0;
+    while (m_HandTable.GetSlot(m_HandTable.ActiveSlotIndex(handIdx)).id != first.handId) {
+      handIdx++;
+    }
+    switch (first.targetIdx) {
+    case NEWS_FEED_TARGET:
+      AppendIntersections(&first, end - begin, newsFeed);
+      break;
+    case CALENDAR_TARGET:
+      buttons[handIdx].calendar = true;
+      break;
+    case RECORD_TARGET:
+      buttons[handIdx].record = true;
+      break;
+    }
+  }
+
+  if (m_ValidateIntersections) {
+    for (int i = 0; i < m_HandTable.Count(); i++) {
+      const HandTable::Slot& slot = m_HandTable.GetSlot(m_HandTable.ActiveSlotIndex(i));
+      const HandInfo& hand = *m_TrackedHands.at(slot.id);
+      for (int targetIdx = 0; targetIdx < NUM_UI_TARGETS; targetIdx++) {
+        size_t begin = 0;
+        while (begin < count && (m_BatchIntersections[begin].targetIdx != targetIdx || m_BatchIntersections[begin].handId != slot.id)) {
+          begin++;
+        }
+        size_t end = begin;
+        while (end < count && m_BatchIntersections[end].targetIdx == targetIdx && m_BatchIntersections[end].handId == slot.id) {
+          end++;
+        }
+        if (targetIdx != NEWS_FEED_TARGET) {
+          positionIconDisk(targetIdx == CALENDAR_TARGET ? CALENDAR_ICON_SLOT : RECORD_ICON_SLOT);
+        }
+        const HandInfo::IntersectionVector expected = targetIdx == NEWS_FEED_TARGET ? hand.IntersectRectangle(*m_NewsFeedRect) : hand.IntersectDisk(*m_IconDisk);
+        validateIntersections(slot, uiTargets[targetIdx], m_BatchIntersections.data() + begin, end - begin, expected);
+      }
+    }
+  }
+}
+
+void Scene::validateIntersections(const HandTable::Slot& hand, const IntersectionTarget& target, const BatchIntersection* results, size_t count, const HandInfo::IntersectionVector& expected) {
+  if (!MatchesIntersections(hand, target, results, count, expected)) {
+    std::ostringstream message;
+    message << "batch intersections of hand " << hand.id << " (" << count << ") don't match HandInfo's (" << expected.size() << ")";
+    throw std::runtime_error(message.str());
+  }
+}
+
+void Scene::updateButtons() {
+  const std::vector<InteractionCache::HandButtons>& buttons = m_InteractionCache.Buttons();
+  for (const InteractionCache::HandButtons& hand : buttons) {
+    if (!hand.calendar) {
+      if (m_ButtonCooldown && m_ButtonAnimation.Value() > 0.99f) {
+        m_ButtonCooldown = false;
+        m_CalendarPressed = false;
+        m_DarkModePressed = false;
+      }
+    } else {
+      if (!m_ButtonCooldown) {
+        m_ButtonCooldown = true;
+        m_CalendarPressed = true;
+        if (m_CalendarOpacity.Goal() == 0.0f) {
+          m_CalendarOpacity.SetGoal(1.0f);
+        } else {
+          m_CalendarOpacity.SetGoal(0.0f);
         }
+        m_ButtonAnimation.SetImmediate(0.0f);
+        m_ButtonAnimation.SetGoal(1.0f);
+      }
+    }
+  }
+
+  for (const InteractionCache::HandButtons& hand : buttons) {
+    if (!hand.record) {
+      if (m_ButtonCooldown && m_ButtonAnimation.Value() > 0.99f) {
+        m_ButtonCooldown = false;
+        m_CalendarPressed = false;
+        m_DarkModePressed = false;
+      }
+    } else {
+      if (!m_ButtonCooldown) {
+        m_ButtonCooldown = true;
+        m_DarkModePressed = true;
+        if (m_ImageOpacity.Goal() == 0.0f) {
+          m_ImageOpacity.SetGoal(1.0f);
+        } else {
+          m_ImageOpacity.SetGoal(0.0f);
+        }
+        m_ButtonAnimation.SetImmediate(0.0f);
+        m_ButtonAnimation.SetGoal(1.0f);
       }
     }
   }
@@ -358,7 +622,7 @@ void Scene::createUI() {
   m_DarkModePressed = false;
 }
 
-void Scene::drawUI() const {
+void Scene::compileUI() {
   const Leap::GL::Rgba<uint8_t> calendarColor(139, 138, 251);
   const Leap::GL::Rgba<uint8_t> emailColor(211, 107, 202);
   const Leap::GL::Rgba<uint8_t> phoneColor(87, 208, 193);
@@ -407,7 +671,7 @@ void Scene::drawUI() const {
     if (alpha > 0.00001f && m_CalendarPressed) {
       m_IconDisk->AddChild(m_AnimationDisk);
     }
-    PrimitiveBase::DrawSceneGraph(*m_IconDisk, m_Renderer);
+    m_UIList.Add(*m_IconDisk);
     if (showCalendar) {
       m_IconDisk->RemoveChild(m_ExpandedPrimitive);
     }
@@ -417,30 +681,6 @@ void Scene::drawUI() const {
     curY -= spacing;
   }
 
-  for (const auto& it : m_TrackedHands) {
-    const HandInfo& trackedHand = *it.second;
-    HandInfo::IntersectionVector intersections = trackedHand.IntersectDisk(*m_IconDisk);
-    if (intersections.empty()) {
-      if (m_ButtonCooldown && m_ButtonAnimation.Value() > 0.99f) {
-        m_ButtonCooldown = false;
-        m_CalendarPressed = false;
-        m_DarkModePressed = false;
-      }
-    } else {
-      if (!m_ButtonCooldown) {
-        m_ButtonCooldown = true;
-        m_CalendarPressed = true;
-        if (m_CalendarOpacity.Goal() == 0.0f) {
-          m_CalendarOpacity.SetGoal(1.0f);
-        } else {
-          m_CalendarOpacity.SetGoal(0.0f);
-        }
-        m_ButtonAnimation.SetImmediate(0.0f);
-        m_ButtonAnimation.SetGoal(1.0f);
-      }
-    }
-  }
-
   {
     m_IconDisk->Material().Uniform<AMBIENT_LIGHT_COLOR>() = emailColor;
     m_IconPrimitive->SetTexture(m_EmailIcon->GetTexture());
@@ -449,7 +689,7 @@ void Scene::drawUI() const {
     m_IconDisk->Translation() << curX, curY, curZ;
     m_IconDisk->LinearTransformation() = faceCameraMatrix(m_IconDisk->Translation(), Globals::userPos, false);
     m_IconPrimitive->LinearTransformation() = scale * Eigen::Matrix3d::Identity();
-    PrimitiveBase::DrawSceneGraph(*m_IconDisk, m_Renderer);
+    m_UIList.Add(*m_IconDisk);
     curY -= spacing;
   }
 
@@ -461,7 +701,7 @@ void Scene::drawUI() const {
     m_IconDisk->Translation() << curX, curY, curZ;
     m_IconDisk->LinearTransformation() = faceCameraMatrix(m_IconDisk->Translation(), Globals::userPos, false);
     m_IconPrimitive->LinearTransformation() = scale * Eigen::Matrix3d::Identity();
-    PrimitiveBase::DrawSceneGraph(*m_IconDisk, m_Renderer);
+    m_UIList.Add(*m_IconDisk);
     curY -= spacing;
   }
 
@@ -476,37 +716,13 @@ void Scene::drawUI() const {
     if (alpha > 0.00001f && m_DarkModePressed) {
       m_IconDisk->AddChild(m_AnimationDisk);
     }
-    PrimitiveBase::DrawSceneGraph(*m_IconDisk, m_Renderer);
+    m_UIList.Add(*m_IconDisk);
     if (alpha > 0.00001f && m_DarkModePressed) {
       m_IconDisk->RemoveChild(m_AnimationDisk);
     }
     curY -= spacing;
   }
 
-  for (const auto& it : m_TrackedHands) {
-    const HandInfo& trackedHand = *it.second;
-    HandInfo::IntersectionVector intersections = trackedHand.IntersectDisk(*m_IconDisk);
-    if (intersections.empty()) {
-      if (m_ButtonCooldown && m_ButtonAnimation.Value() > 0.99f) {
-        m_ButtonCooldown = false;
-        m_CalendarPressed = false;
-        m_DarkModePressed = false;
-      }
-    } else {
-      if (!m_ButtonCooldown) {
-        m_ButtonCooldown = true;
-        m_DarkModePressed = true;
-        if (m_ImageOpacity.Goal() == 0.0f) {
-          m_ImageOpacity.SetGoal(1.0f);
-        } else {
-          m_ImageOpacity.SetGoal(0.0f);
-        }
-        m_ButtonAnimation.SetImmediate(0.0f);
-        m_ButtonAnimation.SetGoal(1.0f);
-      }
-    }
-  }
-
   {
     m_IconDisk->Material().Uniform<AMBIENT_LIGHT_COLOR>() = textColor;
     m_IconPrimitive->SetTexture(m_TextsIcon->GetTexture());
@@ -515,7 +731,7 @@ void Scene::drawUI() const {
     m_IconDisk->Translation() << curX, curY, curZ;
     m_IconDisk->LinearTransformation() = faceCameraMatrix(m_IconDisk->Translation(), Globals::userPos, false);
     m_IconPrimitive->LinearTransformation() = scale * Eigen::Matrix3d::Identity();
-    PrimitiveBase::DrawSceneGraph(*m_IconDisk, m_Renderer);
+    m_UIList.Add(*m_IconDisk);
     curY -= spacing;
   }
 
@@ -526,7 +742,7 @@ void Scene::drawUI() const {
 
     m_ClockText->Material().Uniform<AMBIENT_LIGHT_COLOR>() = clockColor;
     m_ClockText->LinearTransformation() = clockScale * rotation;
-    PrimitiveBase::DrawSceneGraph(*m_ClockText, m_Renderer);
+    m_UIList.Add(*m_ClockText);
   }
 }
 
@@ -567,13 +783,10 @@ void Scene::createNewsFeed() {
   m_FeedScroll = 10000;
 }
 
-void Scene::drawNewsFeed() const {
-  const double feedHeight = 250.0;
-  const double feedWidth = 350.0;
-
-  m_NewsFeedRect->SetSize(Eigen::Vector2d(feedWidth, feedHeight));
-  m_NewsFeedRect->Translation() << -350, 50 + Globals::globalHeightOffset, 250 + Globals::globalZOffset;
-  m_NewsFeedRect->LinearTransformation() = faceCameraMatrix(m_NewsFeedRect->Translation(), Globals::userPos, false);
+void Scene::compileNewsFeed() {
+  // the rectangle itself is laid out by layoutNewsFeed, during Update
+  const double feedHeight = m_NewsFeedRect->Size().y();
+  const double feedWidth = m_NewsFeedRect->Size().x();
 
   double curY = 0;
   const double spacing = 20.0;
@@ -602,19 +815,17 @@ void Scene::drawNewsFeed() const {
     itemIdx = (itemIdx + 1) % m_NewsFeedItems.size();
   }
 
-  for (const auto& it : m_TrackedHands) {
-    const HandInfo& trackedHand = *it.second;
-    HandInfo::IntersectionVector intersections = trackedHand.IntersectRectangle(*m_NewsFeedRect);
-    for (const auto& intersection : intersections) {
-      m_IntersectionDisk->Translation() = intersection.point;
-      m_IntersectionDisk->SetRadius(1.25*intersection.radius);
-      m_IntersectionDisk->Material().Uniform<AMBIENT_LIGHT_COLOR>() = makeIntersectionDiskColor(intersection.confidence);
-      m_IntersectionDisk->LinearTransformation() = m_NewsFeedRect->LinearTransformation();
-      PrimitiveBase::DrawSceneGraph(*m_IntersectionDisk, m_Renderer);
-    }
+  m_NewsFeedIntersectionDisks->Clear();
+  for (const auto& intersection : m_InteractionCache.NewsFeed()) {
+    m_IntersectionDisk->Translation() = intersection.point;
+    m_IntersectionDisk->SetRadius(1.25*intersection.radius);
+    m_IntersectionDisk->Material().Uniform<AMBIENT_LIGHT_COLOR>() = makeIntersectionDiskColor(intersection.confidence);
+    m_IntersectionDisk->LinearTransformation() = m_NewsFeedRect->LinearTransformation();
+    m_NewsFeedIntersectionDisks->Add(*m_IntersectionDisk);
   }
+  m_NewsFeedList.Add(*m_NewsFeedIntersectionDisks);
 
-  PrimitiveBase::DrawSceneGraph(*m_NewsFeedRect, m_Renderer);
+  m_NewsFeedList.Add(*m_NewsFeedRect);
 }
 
 void Scene::createPeople() {
@@ -635,7 +846,7 @@ void Scene::createPeople() {
   m_PersonPrimitive->Translation() << 0, 0, 2.0;
 }
 
-void Scene::drawPeople() const {
+void Scene::compilePeople() {
   const double radius = m_PersonBG->Radius();
   const double spacing = 3 * radius;
   double curX = -spacing;
@@ -653,7 +864,7 @@ void Scene::drawPeople() const {
     m_PersonPrimitive->SetScaleBasedOnTextureSize();
     const double scale = 2.5 * radius / m_PersonPrimitive->Size().norm();
     m_PersonPrimitive->LinearTransformation() = scale * Eigen::Matrix3d::Identity();
-    PrimitiveBase::DrawSceneGraph(*m_PersonBG, m_Renderer);
+    m_PeopleList.Add(*m_PersonBG);
     curX += spacing;
   }
 
@@ -665,7 +876,7 @@ void Scene::drawPeople() const {
     m_PersonPrimitive->SetScaleBasedOnTextureSize();
     const double scale = 2.5 * radius / m_PersonPrimitive->Size().norm();
     m_PersonPrimitive->LinearTransformation() = scale * Eigen::Matrix3d::Identity();
-    PrimitiveBase::DrawSceneGraph(*m_PersonBG, m_Renderer);
+    m_PeopleList.Add(*m_PersonBG);
     curX += spacing;
   }
 
@@ -680,7 +891,7 @@ void Scene::drawPeople() const {
     m_PersonPrimitive->SetScaleBasedOnTextureSize();
     const double scale = 2.5 * radius / m_PersonPrimitive->Size().norm();
     m_PersonPrimitive->LinearTransformation() = scale * Eigen::Matrix3d::Identity();
-    PrimitiveBase::DrawSceneGraph(*m_PersonBG, m_Renderer);
+    m_PeopleList.Add(*m_PersonBG);
     curX += spacing;
   }
 }
@@ -2,30 +2,69 @@
 
 #include "ImagePassthrough.h"
 #include "HandInfo.h"
+#include "HandTable.h"
+#include "HandIntersection.h"
+#include "InteractionCache.h"
 #include "TextureFont/TextPrimitive.h"
 #include "GLTexture2Image/GLTexture2Image.h"
+#include "LeapListener/FrameReplaySource.h"
+#include "Primitives/InstancedBatch.h"
+#include "Primitives/RenderList.h"
 #include "utility/Animation.h"
 
+class FakeWindow;
+class WindowManager;
+
 class Scene {
 public:
   Scene();
   void Init();
   void SetInputTransform(const EigenTypes::Matrix3x3& rotation, const EigenTypes::Vector3& translation);
+  // When replaying a recording, the tracked quad and images come from the replay
+  // source rather than from the (deserialized) frames.
+  void SetReplaySource(const std::shared_ptr<FrameReplaySource>& replay) { m_Replay = replay; }
+  // How far ahead of the latest tracking frame to draw the hands, in seconds.
+  void SetPredictionHorizon(double seconds) { m_PredictionHorizon = seconds; }
+  // If more than this many frames are given to Update, only the newest ones are
+  // processed, so that a backlog can't make the next update slower still.  Zero
+  // processes every frame.
+  void SetMaxFramesPerUpdate(size_t maxFrames) { m_MaxFramesPerUpdate = maxFrames; }
+  // Also compute every intersection with HandInfo's own functions, and throw if the
+  // batch results disagree with them.  Slow; for debugging the batch kernel.
+  void SetValidateIntersections(bool validate) { m_ValidateIntersections = validate; }
+  uint64_t CoalescedFrameCount() const { return m_CoalescedFrameCount; }
   void Update(const std::deque<Leap::Frame>& frames);
+  // Device timestamp (microseconds) of the most recent frame given to Update.
+  int64_t LatestFrameTimestamp() const { return m_CurFrame.timestamp(); }
   void Render(const Eigen::Matrix4f& proj, const Eigen::Matrix4f& view, int eyeIdx) const;
 private:
 
-  void updateTrackedHands(float deltaTime);
+  // Positions of the pressable icons in the column compiled by compileUI.
+  static const int CALENDAR_ICON_SLOT = 0;
+  static const int RECORD_ICON_SLOT = 3;
+
+  // Indices of the targets intersected by updateInteractionCache, besides the windows.
+  enum { NEWS_FEED_TARGET, CALENDAR_TARGET, RECORD_TARGET, NUM_UI_TARGETS };
+
+  void updateTrackedHands(float deltaTime, int numSteps);
+  void updateTrackedQuad(const Leap::Frame& frame);
+  void queryWindowCandidates(const WindowManager& manager);
+  void layoutNewsFeed();
+  void positionIconDisk(int slot) const;
+  void updateInteractionCache();
+  static void validateIntersections(const HandTable::Slot& hand, const IntersectionTarget& target, const BatchIntersection* results, size_t count, const HandInfo::IntersectionVector& expected);
   void leapInteract(float deltaTime);
+  void updateButtons();
   void drawHands() const;
   void drawFakeMouse() const;
-  void drawWindows() const;
+  void compileRenderLists();
+  void compileWindows();
   void createUI();
-  void drawUI() const;
+  void compileUI();
   void createNewsFeed();
-  void drawNewsFeed() const;
+  void compileNewsFeed();
   void createPeople();
-  void drawPeople() const;
+  void compilePeople();
   static Leap::GL::Rgba<float> makeIntersectionDiskColor(double confidence);
 
   EigenTypes::Matrix3x3 m_InputRotation;
@@ -33,9 +72,34 @@ private:
   mutable RenderState m_Renderer;
   std::shared_ptr<ImagePassthrough> m_ImagePassthrough;
 
+  std::shared_ptr<FrameReplaySource> m_Replay;
   Leap::Frame m_PrevFrame;
   Leap::Frame m_CurFrame;
   HandInfoMap m_TrackedHands;
+  HandTable m_HandTable; // flat copy of m_TrackedHands, refreshed by updateInteractionCache
+  double m_PredictionHorizon;
+  size_t m_MaxFramesPerUpdate;
+  uint64_t m_CoalescedFrameCount;
+
+  // Per hand in m_HandTable, the windows near enough to possibly intersect it.
+  struct HandWindowCandidates {
+    int slotIdx;
+    const HandInfo* hand;
+    std::vector<FakeWindow*> windows;
+  };
+  std::vector<HandWindowCandidates> m_WindowCandidates;
+  // The (window, index into m_WindowCandidates) pairs of all the candidates, grouped by window.
+  std::vector<std::pair<FakeWindow*, size_t>> m_CandidatePairs;
+  InteractionCache m_InteractionCache;
+  bool m_ValidateIntersections;
+  // Scratch output of the batch kernel; large enough for every hand against every UI target.
+  std::vector<BatchIntersection> m_BatchIntersections;
+
+  // Compiled once per Update by compileRenderLists, then drawn for each eye.
+  RenderList m_WindowList;
+  RenderList m_UIList;
+  RenderList m_NewsFeedList;
+  RenderList m_PeopleList;
 
   std::shared_ptr<TextureFont> m_Font;
   std::shared_ptr<TextPrimitive> m_ClockText;
@@ -54,22 +118,23 @@ private:
   GLTexture2ImageRef m_TextsIcon;
 
   std::shared_ptr<Disk> m_IntersectionDisk;
+  std::shared_ptr<InstancedBatch> m_NewsFeedIntersectionDisks;
   Smoothed<Eigen::Vector3d> m_ScreenPositionSmoother;
   Smoothed<Eigen::Matrix3d> m_ScreenRotationSmoother;
 
-  mutable bool m_ButtonCooldown;
-  mutable Smoothed<float> m_CalendarOpacity;
-  mutable Smoothed<float> m_ButtonAnimation;
-  mutable bool m_CalendarPressed;
-  mutable bool m_DarkModePressed;
-  mutable Smoothed<float> m_ImageOpacity;
+  bool m_ButtonCooldown;
+  Smoothed<float> m_CalendarOpacity;
+  Smoothed<float> m_ButtonAnimation;
+  bool m_CalendarPressed;
+  bool m_DarkModePressed;
+  Smoothed<float> m_ImageOpacity;
 
   std::chrono::steady_clock::time_point m_GestureStart;
   bool m_ActivationGesture;
   bool m_DeactivationGesture;
 
   std::vector<std::shared_ptr<TextPrimitive>> m_NewsFeedItems;
-  mutable double m_FeedScroll;
+  double m_FeedScroll;
   Smoothed<double> m_ScrollVel;
   std::shared_ptr<RectanglePrim> m_NewsFeedRect;
 
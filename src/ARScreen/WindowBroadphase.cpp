@@ -0,0 +1,146 @@
+#include "stdafx.h"
+#include "WindowBroadphase.h"
+
+#include <cmath>
+
+WindowBroadphase::WindowBroadphase(double cellSize) :
+  m_CellSize(cellSize),
+  m_QueryStamp(0)
+{ }
+
+void WindowBroadphase::Update(FakeWindow* window, const Eigen::AlignedBox3d& bounds) {
+  auto it = m_Entries.find(window);
+  const bool isNew = it == m_Entries.end();
+  if (isNew) {
+    it = m_Entries.insert(std::make_pair(window, Entry())).first;
+    it->second.window = window;
+    it->second.queryStamp = 0;
+  }
+  Entry& entry = it->second;
+  entry.bounds = bounds;
+
+  const int minX = cellCoord(bounds.min().x());
+  const int minY = cellCoord(bounds.min().y());
+  const int maxX = cellCoord(bounds.max().x());
+  const int maxY = cellCoord(bounds.max().y());
+  if (!isNew && minX == entry.minX && minY == entry.minY && maxX == entry.maxX && maxY == entry.maxY) {
+    return; // still covers the same cells
+  }
+  if (!isNew) {
+    removeCells(entry);
+  }
+  entry.minX = minX;
+  entry.minY = minY;
+  entry.maxX = maxX;
+  entry.maxY = maxY;
+  insertCells(entry);
+}
+
+void WindowBroadphase::Remove(FakeWindow* window) {
+  auto it = m_Entries.find(window);
+  if (it == m_Entries.end()) {
+    return;
+  }
+  removeCells(it->second);
+  m_Entries.erase(it);
+}
+
+void WindowBroadphase::Clear() {
+  m_Entries.clear();
+  m_Cells.clear();
+  m_Oversized.clear();
+}
+
+void WindowBroadphase::Query(const Eigen::AlignedBox3d& bounds, std::vector<FakeWindow*>& candidates) const {
+  if (bounds.isEmpty()) {
+    return;
+  }
+  const uint32_t stamp = ++m_QueryStamp;
+  auto test = [&] (const Entry* entry) {
+    if (entry->queryStamp != stamp) {
+      entry->queryStamp = stamp;
+      if (entry->bounds.intersects(bounds)) {
+        candidates.push_back(entry->window);
+      }
+    }
+  };
+
+  const int minX = cellCoord(bounds.min().x());
+  const int minY = cellCoord(bounds.min().y());
+  const int maxX = cellCoord(bounds.max().x());
+  const int maxY = cellCoord(bounds.max().y());
+  if (static_cast<int64_t>(maxX - minX + 1) * (maxY - minY + 1) > static_cast<int64_t>(m_Cells.size())) {
+    // the query covers more cells than are occupied, so visit the occupied ones instead
+    for (const auto& cell : m_Cells) {
+      for (const Entry* entry : cell.second) {
+        test(entry);
+      }
+    }
+  } else {
+    for (int x = minX; x <= maxX; x++) {
+      for (int y = minY; y <= maxY; y++) {
+        const auto it = m_Cells.find(cellKey(x, y));
+        if (it != m_Cells.end()) {
+          for (const Entry* entry : it->second) {
+            test(entry);
+          }
+        }
+      }
+    }
+  }
+  for (const Entry* entry : m_Oversized) {
+    test(entry);
+  }
+}
+
+int WindowBroadphase::cellCoord(double value) const {
+  const double cell = std::floor(value / m_CellSize);
+  // keep the coordinates well inside the range of int, even for far-away boxes
+  return static_cast<int>(std::max(-1.0e6, std::min(1.0e6, cell)));
+}
+
+uint64_t WindowBroadphase::cellKey(int x, int y) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+void WindowBroadphase::removeFrom(EntryList& list, Entry* entry) {
+  for (size_t i = 0; i < list.size(); i++) {
+    if (list[i] == entry) {
+      list[i] = list.back();
+      list.pop_back();
+      return;
+    }
+  }
+}
+
+void WindowBroadphase::insertCells(Entry& entry) {
+  const int64_t numCells = static_cast<int64_t>(entry.maxX - entry.minX + 1) * (entry.maxY - entry.minY + 1);
+  entry.oversized = numCells > MAX_CELLS_PER_ENTRY;
+  if (entry.oversized) {
+    m_Oversized.push_back(&entry);
+    return;
+  }
+  for (int x = entry.minX; x <= entry.maxX; x++) {
+    for (int y = entry.minY; y <= entry.maxY; y++) {
+      m_Cells[cellKey(x, y)].push_back(&entry);
+    }
+  }
+}
+
+void WindowBroadphase::removeCells(Entry& entry) {
+  if (entry.oversized) {
+    removeFrom(m_Oversized, &entry);
+    return;
+  }
+  for (int x = entry.minX; x <= entry.maxX; x++) {
+    for (int y = entry.minY; y <= entry.maxY; y++) {
+      const auto it = m_Cells.find(cellKey(x, y));
+      if (it != m_Cells.end()) {
+        removeFrom(it->second, &entry);
+        if (it->second.empty()) {
+          m_Cells.erase(it);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "utility/EigenTypes.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class FakeWindow;
+
+// A uniform grid over the world-space bounding boxes of the window quads, used to
+// find the few windows near a hand before doing exact hand-vs-window tests.
+//
+// The grid partitions the xy plane (the windows are laid out roughly facing the
+// user, so z carries little information); z is only checked against each
+// candidate's box.  Entries are updated incrementally: moving a window only
+// touches the grid if it changes which cells it overlaps.
+class WindowBroadphase {
+public:
+  explicit WindowBroadphase(double cellSize = 100.0);
+
+  // Inserts the window, or moves it if it's already present.
+  void Update(FakeWindow* window, const Eigen::AlignedBox3d& bounds);
+  void Remove(FakeWindow* window);
+  void Clear();
+
+  // Appends every window whose bounding box overlaps the given box.  Each
+  // window is reported at most once.
+  void Query(const Eigen::AlignedBox3d& bounds, std::vector<FakeWindow*>& candidates) const;
+
+  size_t Size() const { return m_Entries.size(); }
+
+private:
+  // Windows spanning more cells than this are kept in a separate list which is
+  // always checked, rather than being added to every cell.
+  static const int MAX_CELLS_PER_ENTRY = 256;
+
+  struct Entry {
+    FakeWindow* window;
+    Eigen::AlignedBox3d bounds;
+    int minX, minY, maxX, maxY;
+    bool oversized;
+    mutable uint32_t queryStamp;
+  };
+  typedef std::vector<Entry*> EntryList;
+
+  int cellCoord(double value) const;
+  static uint64_t cellKey(int x, int y);
+  static void removeFrom(EntryList& list, Entry* entry);
+  void insertCells(Entry& entry);
+  void removeCells(Entry& entry);
+
+  double m_CellSize;
+  std::unordered_map<FakeWindow*, Entry> m_Entries;
+  std::unordered_map<uint64_t, EntryList> m_Cells;
+  EntryList m_Oversized;
+  mutable uint32_t m_QueryStamp;
+};
@@ -3,9 +3,21 @@
 #include "utility/Utilities.h"
 #include "OSInterface/OSVirtualScreen.h"
 
-FakeWindow::FakeWindow(OSWindow& window) : m_Window(window), m_UpdateSize(false), m_UpdatePosition(false), m_ForceUpdate(false), m_ZOrder(0.0), m_PositionOffset(Eigen::Vector3d::Zero()), m_Opacity(0.0f), m_HaveSnapshot(false) {
+FakeWindow::FakeWindow(OSWindow& window, WindowSmoothers& smoothers) : m_Window(window), m_UpdateSize(false), m_UpdatePosition(false), m_ForceUpdate(false), m_Smoothers(smoothers), m_HaveSnapshot(false) {
   m_Texture = std::shared_ptr<ImagePrimitive>(new ImagePrimitive());
-  m_ZOrder.SetSmoothStrength(0.7f);
+  m_PositionOffset = m_Smoothers.motion.AddVector3(Eigen::Vector3d::Zero());
+  m_Opacity = m_Smoothers.motion.AddScalar(0.0f);
+  m_ZOrder = m_Smoothers.zOrder.AddScalar(0.0f, 0.7f);
+}
+
+FakeWindow::~FakeWindow() {
+  m_Smoothers.motion.Remove(m_PositionOffset);
+  m_Smoothers.motion.Remove(m_Opacity);
+  m_Smoothers.zOrder.Remove(m_ZOrder);
+}
+
+void FakeWindow::UpdateGoals() {
+  m_Smoothers.zOrder.SetGoal(m_ZOrder, static_cast<float>(m_Window.GetZOrder()));
 }
 
 void FakeWindow::Update(const WindowTransform& transform, double deltaTime) {
@@ -47,28 +59,32 @@ void FakeWindow::Update(const WindowTransform& transform, double deltaTime) {
     m_Window.SetPosition(newPos);
   }
 
-  m_ZOrder.SetGoal(m_Window.GetZOrder());
-  m_ZOrder.Update(deltaTime);
-
-  m_PositionOffset.Update(deltaTime);
-  m_Opacity.Update(deltaTime);
-
   m_OSPosition = windowPos + 0.5*windowSize;
   m_OSPosition.y() *= -1.0;
 
   m_Texture->Translation() = transform.Forward(m_OSPosition);
-  m_Texture->Translation().z() += 20.0 * m_ZOrder.Value();
-  m_Texture->Translation() += m_PositionOffset.Value();
+  m_Texture->Translation().z() += 20.0 * m_Smoothers.zOrder.Value(m_ZOrder);
+  m_Texture->Translation() += m_Smoothers.motion.Vector3Value(m_PositionOffset);
   const Eigen::Matrix3d scaleMatrix = (transform.scale * Eigen::Vector3d(1, -1, 1)).asDiagonal();
   //m_Texture->LinearTransformation() = faceCameraMatrix(m_Texture->Translation(), Globals::userPos, false) * scaleMatrix;
   m_Texture->LinearTransformation() = scaleMatrix;
 
-  m_Texture->Material().Uniform<AMBIENT_LIGHT_COLOR>().A() = m_Opacity.Value();
+  m_Texture->Material().Uniform<AMBIENT_LIGHT_COLOR>().A() = m_Smoothers.motion.Value(m_Opacity);
 
   m_ForceUpdate = false;
 }
 
-void FakeWindow::Interact(const WindowTransform& transform, const HandInfoMap& hands, float deltaTime) {
+Eigen::AlignedBox3d FakeWindow::WorldBounds() const {
+  // read through a const reference, since non-const access invalidates the cached global properties
+  const RectanglePrim& texture = *m_Texture;
+  const Eigen::Vector3d center = texture.Translation();
+  const Eigen::Matrix3d linear = texture.LinearTransformation();
+  const Eigen::Vector3d halfSize(0.5*texture.Size().x(), 0.5*texture.Size().y(), 0.0);
+  const Eigen::Vector3d extent = linear.cwiseAbs() * halfSize;
+  return Eigen::AlignedBox3d(center - extent, center + extent);
+}
+
+void FakeWindow::Interact(const WindowTransform& transform, const std::vector<HandInfo::IntersectionVector>& intersectionsPerHand, float deltaTime) {
   Eigen::vector<Eigen::Vector2d> movementsPerHand;
   Eigen::vector<Eigen::Vector2d> positionsPerHand;
 
@@ -78,9 +94,7 @@ void FakeWindow::Interact(const WindowTransform& transform, const HandInfoMap& h
   m_PositionVel.setZero();
   m_SizeVel.setZero();
 
-  for (const auto& it : hands) {
-    const HandInfo& hand = *it.second;
-    HandInfo::IntersectionVector intersections = hand.IntersectRectangle(*m_Texture);
+  for (const HandInfo::IntersectionVector& intersections : intersectionsPerHand) {
     Eigen::Vector2d sumPixelMovement = Eigen::Vector2d::Zero();
     Eigen::Vector2d sumPixelPosition = Eigen::Vector2d::Zero();
     int numSum = 0;
@@ -154,17 +168,18 @@ void WindowManager::OnCreate(OSWindow& window) {
     return;
   }
 
-  std::shared_ptr<FakeWindow> newWindow = std::shared_ptr<FakeWindow>(new FakeWindow(window));
+  std::shared_ptr<FakeWindow> newWindow = std::shared_ptr<FakeWindow>(new FakeWindow(window, m_Smoothers));
   newWindow->m_ForceUpdate = true;
 
-  newWindow->m_PositionOffset.SetImmediate(Eigen::Vector3d(0, 0, -1000));
-  newWindow->m_Opacity.SetImmediate(0.0f);
-  newWindow->m_PositionOffset.SetSmoothStrength(baseSmooth);
-  newWindow->m_Opacity.SetSmoothStrength(baseSmooth);
+  SmoothedBank<10>& motion = m_Smoothers.motion;
+  motion.SetImmediate(newWindow->m_PositionOffset, Eigen::Vector3d(0, 0, -1000));
+  motion.SetImmediate(newWindow->m_Opacity, 0.0f);
+  motion.SetSmoothStrength(newWindow->m_PositionOffset, baseSmooth);
+  motion.SetSmoothStrength(newWindow->m_Opacity, baseSmooth);
 
   if (m_Active) {
-    newWindow->m_Opacity.SetGoal(1.0f);
-    newWindow->m_PositionOffset.SetGoal(Eigen::Vector3d::Zero());
+    motion.SetGoal(newWindow->m_Opacity, 1.0f);
+    motion.SetGoal(newWindow->m_PositionOffset, Eigen::Vector3d::Zero());
   }
 
   m_Windows[windowPtr] = newWindow;
@@ -177,6 +192,7 @@ void WindowManager::OnDestroy(OSWindow& window) {
     return;
   }
 
+  m_Broadphase.Remove(q->second.get());
   m_Windows.erase(q);
 }
 
@@ -211,8 +227,14 @@ void WindowManager::Tick(std::chrono::duration<double> deltaT) {
   }
 
   std::unique_lock<std::mutex> lock(m_WindowsMutex);
+  for (const auto& it : m_Windows) {
+    it.second->UpdateGoals();
+  }
+  m_Smoothers.motion.Update(static_cast<float>(deltaT.count()));
+  m_Smoothers.zOrder.Update(static_cast<float>(deltaT.count()));
   for (const auto& it : m_Windows) {
     it.second->Update(*m_WindowTransform, deltaT.count());
+    m_Broadphase.Update(it.second.get(), it.second->WorldBounds());
   }
 }
 
@@ -224,10 +246,10 @@ void WindowManager::Activate() {
     const int z = it.second->m_Window.GetZOrder();
     const float zRatio = static_cast<float>(z - minZ) / static_cast<float>(maxZ - minZ);
     const float smooth = baseSmooth + smoothVariation * (1.0f - zRatio);
-    it.second->m_PositionOffset.SetSmoothStrength(smooth);
-    it.second->m_Opacity.SetSmoothStrength(smooth);
-    it.second->m_Opacity.SetGoal(1.0f);
-    it.second->m_PositionOffset.SetGoal(Eigen::Vector3d::Zero());
+    m_Smoothers.motion.SetSmoothStrength(it.second->m_PositionOffset, smooth);
+    m_Smoothers.motion.SetSmoothStrength(it.second->m_Opacity, smooth);
+    m_Smoothers.motion.SetGoal(it.second->m_Opacity, 1.0f);
+    m_Smoothers.motion.SetGoal(it.second->m_PositionOffset, Eigen::Vector3d::Zero());
   }
   m_Active = true;
 }
@@ -240,10 +262,10 @@ void WindowManager::Deactivate() {
     const int z = it.second->m_Window.GetZOrder();
     const float zRatio = static_cast<float>(z - minZ) / static_cast<float>(maxZ - minZ);
     const float smooth = baseSmooth + smoothVariation * zRatio;
-    it.second->m_PositionOffset.SetSmoothStrength(smooth);
-    it.second->m_Opacity.SetSmoothStrength(smooth);
-    it.second->m_Opacity.SetGoal(0.0f);
-    it.second->m_PositionOffset.SetGoal(Eigen::Vector3d(0, 0, -1000));
+    m_Smoothers.motion.SetSmoothStrength(it.second->m_PositionOffset, smooth);
+    m_Smoothers.motion.SetSmoothStrength(it.second->m_Opacity, smooth);
+    m_Smoothers.motion.SetGoal(it.second->m_Opacity, 0.0f);
+    m_Smoothers.motion.SetGoal(it.second->m_PositionOffset, Eigen::Vector3d(0, 0, -1000));
   }
   m_Active = false;
 }
@@ -5,9 +5,11 @@
 #include "OSInterface/OSWindowEvent.h"
 #include "utility/Updatable.h"
 #include "utility/Animation.h"
+#include "utility/SmoothedBank.h"
 #include "Primitives/Primitives.h"
 #include "HandInfo.h"
 #include "Globals.h"
+#include "WindowBroadphase.h"
 
 struct WindowTransform {
   WindowTransform() : scale(1.0), center(Eigen::Vector2d::Zero()), offset(Eigen::Vector3d::Zero()), rotation(Eigen::Matrix3d::Identity()) {}
@@ -32,11 +34,24 @@ struct WindowTransform {
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
 
+// The smoothed animation state of every window, kept in banks so that it can be
+// updated in one pass by WindowManager::Tick rather than window by window.
+struct WindowSmoothers {
+  SmoothedBank<10> motion; // position offsets and opacities
+  SmoothedBank<> zOrder;
+};
+
 class FakeWindow {
 public:
-  FakeWindow(OSWindow& window);
+  FakeWindow(OSWindow& window, WindowSmoothers& smoothers);
+  ~FakeWindow();
+  // Sets the goals of the smoothers, which WindowManager then updates.
+  void UpdateGoals();
   void Update(const WindowTransform& transform, double deltaTime);
-  void Interact(const WindowTransform& transform, const HandInfoMap& hands, float deltaTime);
+  // Takes the intersections of each hand which touches the window this frame.
+  void Interact(const WindowTransform& transform, const std::vector<HandInfo::IntersectionVector>& intersectionsPerHand, float deltaTime);
+  // Axis-aligned box around the window quad, in the same space as the hands.
+  Eigen::AlignedBox3d WorldBounds() const;
   std::shared_ptr<ImagePrimitive> m_Texture;
   OSWindow& m_Window;
   Eigen::Vector2d m_OSPosition;
@@ -45,9 +60,10 @@ public:
   bool m_UpdatePosition;
   Eigen::Vector2d m_SizeVel;
   Eigen::Vector2d m_PositionVel;
-  Smoothed<double> m_ZOrder;
-  Smoothed<Eigen::Vector3d, 10> m_PositionOffset;
-  Smoothed<float, 10> m_Opacity;
+  WindowSmoothers& m_Smoothers;
+  SmoothedBank<10>::Channel m_PositionOffset;
+  SmoothedBank<10>::Channel m_Opacity;
+  SmoothedBank<>::Channel m_ZOrder;
   bool m_HaveSnapshot;
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
@@ -72,9 +88,11 @@ public:
   // Updatable overrides:
   void Tick(std::chrono::duration<double> deltaT) override;
 
+  WindowSmoothers m_Smoothers; // declared before m_Windows, which removes its channels from it
   std::unordered_map<std::shared_ptr<OSWindow>, std::shared_ptr<FakeWindow>> m_Windows;
   int m_RoundRobinCounter;
   std::shared_ptr<WindowTransform> m_WindowTransform;
+  WindowBroadphase m_Broadphase; // kept up to date with the window quads by Tick
   bool m_Active;
 private:
   void Run() override;
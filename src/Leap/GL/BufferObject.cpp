@@ -3,6 +3,7 @@
 
 #include <cassert>
 #include "Leap/GL/Error.h"
+#include "Leap/GL/StateCache.h"
 
 namespace Leap {
 namespace GL {
@@ -29,14 +30,14 @@ void BufferObject::Bind () const {
   if (!IsInitialized()) {
     throw Leap::GL::Exception("Can't call BufferObject::Bind on a BufferObject that is !IsInitialized().");
   }
-  THROW_UPON_GL_ERROR(glBindBuffer(m_BufferType, m_BufferAddress));
+  StateCache::Current().BindBuffer(m_BufferType, m_BufferAddress);
 }
 
 void BufferObject::Unbind () const {
   if (!IsInitialized()) {
     throw Leap::GL::Exception("Can't call BufferObject::Unbind on a BufferObject that is !IsInitialized().");
   }
-  THROW_UPON_GL_ERROR(glBindBuffer(m_BufferType, 0));
+  StateCache::Current().BindBuffer(m_BufferType, 0);
 }
 
 void BufferObject::BufferData (const void* data, GLsizeiptr size_in_bytes, GLenum usage_pattern) {
@@ -54,6 +55,13 @@ void BufferObject::BufferSubData (const void* data, int count) {
   THROW_UPON_GL_ERROR(glBufferSubData(m_BufferType, 0, count, data));
 }
 
+void BufferObject::BufferSubData (GLintptr offset, const void* data, GLsizeiptr size) {
+  if (!IsInitialized()) {
+    throw Leap::GL::Exception("Can't call BufferObject::BufferSubData on a BufferObject that is !IsInitialized().");
+  }
+  THROW_UPON_GL_ERROR(glBufferSubData(m_BufferType, offset, size, data));
+}
+
 void* BufferObject::MapBuffer (GLenum access) {
   if (!IsInitialized()) {
     throw Leap::GL::Exception("Can't call BufferObject::MapBuffer on a BufferObject that is !IsInitialized().");
@@ -64,6 +72,16 @@ void* BufferObject::MapBuffer (GLenum access) {
   return ptr;
 }
 
+void* BufferObject::MapBufferRange (GLintptr offset, GLsizeiptr size, GLbitfield access) {
+  if (!IsInitialized()) {
+    throw Leap::GL::Exception("Can't call BufferObject::MapBufferRange on a BufferObject that is !IsInitialized().");
+  }
+  Bind();
+  THROW_UPON_GL_ERROR(void *ptr = glMapBufferRange(m_BufferType, offset, size, access));
+  Unbind();
+  return ptr;
+}
+
 bool BufferObject::UnmapBuffer () {
   if (!IsInitialized()) {
     throw Leap::GL::Exception("Can't call BufferObject::UnmapBuffer on a BufferObject that is !IsInitialized().");
@@ -82,6 +100,7 @@ void BufferObject::Initialize_Implementation (GLenum type) {
 
 void BufferObject::Shutdown_Implementation () {
   glDeleteBuffers(1, &m_BufferAddress);
+  StateCache::Current().ForgetBuffer(m_BufferAddress);
   m_BufferAddress = 0;
   m_SizeInBytes = 0;
 }
@@ -44,6 +44,12 @@ public:
   /// @details The work is done via glBufferSubData.  Will throw a Leap::GL::Exception if
   /// !IsInitialized or if there was an error in the glBufferSubData operation.
   void BufferSubData (const void* data, int count);
+  /// @brief Specifies the data to be altered in this buffer, starting offset bytes in.
+  /// @details The work is done via glBufferSubData.  Will throw a Leap::GL::Exception if
+  /// !IsInitialized or if there was an error in the glBufferSubData operation.
+  void BufferSubData (GLintptr offset, const void* data, GLsizeiptr size);
+  /// @brief Returns the buffer object's name (its handle in the GL apparatus), e.g. for glBindBufferRange.
+  GLuint Address () const { return m_BufferAddress; }
   /// @brief Returns the number of bytes of data stored by this buffer.
   GLsizeiptr Size () const { return m_SizeInBytes; }
   /// @brief Maps the contents of this buffer to memory to which a pointer is returned.
@@ -51,6 +57,11 @@ public:
   /// before and after glMapBuffer, respectively.  Will throw a Leap::GL::Exception if
   /// !IsInitialized or if there was an error in the glMapBuffer operation.
   void* MapBuffer (GLenum access);
+  /// @brief Maps size bytes of this buffer, starting offset bytes in, to memory to which a pointer is returned.
+  /// @details The work is done via glMapBufferRange (OpenGL 3.0 or ARB_map_buffer_range), and access is a
+  /// combination of its GL_MAP_* flags.  Bind and Unbind are called as for MapBuffer, and the session is
+  /// likewise ended with UnmapBuffer.
+  void* MapBufferRange (GLintptr offset, GLsizeiptr size, GLbitfield access);
   /// @brief Ends a `MapBuffer` session.
   /// @details The work is done via glUnmapBuffer.  The Bind and Unbind methods will be called
   /// before and after glMapBuffer, respectively.  Will throw a Leap::GL::Exception if
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Leap/GL/GLHeaders.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace Leap {
+namespace GL {
+// The contents of the Internal namespace are not intended to be used publicly, and provide
+// no guarantee as to the stability of their API.  The classes and functions are used
+// internally in the implementation of the publicly-presented classes.
+namespace Internal {
+
+// Converts a float to IEEE 754 half precision, rounding to nearest.  Values too large for a
+// half become infinity, and values too small become (signed) zero.
+inline GLushort FloatToHalf (float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint32_t sign = (bits >> 16) & 0x8000;
+  const int32_t float_exponent = static_cast<int32_t>((bits >> 23) & 0xFF);
+  uint32_t mantissa = bits & 0x7FFFFF;
+  if (float_exponent == 0xFF) { // infinity or NaN
+    return static_cast<GLushort>(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+  }
+  const int32_t exponent = float_exponent - 127 + 15;
+  if (exponent >= 31) { // overflow
+    return static_cast<GLushort>(sign | 0x7C00);
+  }
+  if (exponent <= 0) { // subnormal half, or underflow
+    if (exponent < -10) {
+      return static_cast<GLushort>(sign);
+    }
+    mantissa |= 0x800000; // the implicit leading bit
+    const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+    uint32_t half = mantissa >> shift;
+    if ((mantissa >> (shift - 1)) & 1) {
+      ++half;
+    }
+    return static_cast<GLushort>(sign | half);
+  }
+  uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+  if (mantissa & 0x1000) {
+    ++half; // a carry out of the mantissa correctly increments the exponent
+  }
+  return static_cast<GLushort>(half);
+}
+
+// This is a metafunction which defines, for each packed vertex attribute format (named by the
+// type enum passed to glVertexAttribPointer), the storage type, the number of components the
+// shader receives, whether the components are normalized, and how to pack a value into the
+// storage.  The value can be any type (e.g. an Eigen vector) whose components are accessible
+// via operator [], and which has at least COUNT of them (only 3 for GL_INT_2_10_10_10_REV).
+template <GLenum PACKED_TYPE> struct PackedVertexAttributeReflection;
+
+// A signed, normalized 3-vector (e.g. a normal) packed into 10 bits per component.  The 2-bit
+// w component is 0.
+template <>
+struct PackedVertexAttributeReflection<GL_INT_2_10_10_10_REV> {
+  typedef GLuint Storage;
+  static const GLint COUNT = 4;
+  static const GLboolean NORMALIZED = GL_TRUE;
+  static bool IsSupported () { return GLEW_VERSION_3_3 || GLEW_ARB_vertex_type_2_10_10_10_rev; }
+  template <typename T_>
+  static Storage Pack (const T_ &value) {
+    auto Pack10 = [] (float component) {
+      const long packed = std::lround(std::max(-1.0f, std::min(1.0f, component)) * 511.0f);
+      return static_cast<GLuint>(packed) & 0x3FF;
+    };
+    return Pack10(static_cast<float>(value[0])) | (Pack10(static_cast<float>(value[1])) << 10) | (Pack10(static_cast<float>(value[2])) << 20);
+  }
+};
+
+// A 2-vector (e.g. a texture coordinate) stored as half-precision floats.
+template <>
+struct PackedVertexAttributeReflection<GL_HALF_FLOAT> {
+  typedef std::array<GLushort,2> Storage;
+  static const GLint COUNT = 2;
+  static const GLboolean NORMALIZED = GL_FALSE;
+  static bool IsSupported () { return GLEW_VERSION_3_0 || GLEW_ARB_half_float_vertex; }
+  template <typename T_>
+  static Storage Pack (const T_ &value) {
+    Storage storage = {{ FloatToHalf(static_cast<float>(value[0])), FloatToHalf(static_cast<float>(value[1])) }};
+    return storage;
+  }
+};
+
+// A 4-vector with components in [0,1] (e.g. an RGBA color) stored as normalized unsigned bytes.
+template <>
+struct PackedVertexAttributeReflection<GL_UNSIGNED_BYTE> {
+  typedef std::array<GLubyte,4> Storage;
+  static const GLint COUNT = 4;
+  static const GLboolean NORMALIZED = GL_TRUE;
+  static bool IsSupported () { return true; }
+  template <typename T_>
+  static Storage Pack (const T_ &value) {
+    auto Pack8 = [] (float component) {
+      return static_cast<GLubyte>(std::lround(std::max(0.0f, std::min(1.0f, component)) * 255.0f));
+    };
+    Storage storage = {{ Pack8(static_cast<float>(value[0])), Pack8(static_cast<float>(value[1])), Pack8(static_cast<float>(value[2])), Pack8(static_cast<float>(value[3])) }};
+    return storage;
+  }
+};
+
+} // end of namespace Internal
+} // end of namespace GL
+} // end of namespace Leap
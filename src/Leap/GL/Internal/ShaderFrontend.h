@@ -74,6 +74,28 @@ typename std::enable_if<UniformTraits<GL_TYPE_>::IS_MATRIX_TYPE>::type Uniformiz
   UniformTraits<GL_TYPE_>::UploadUsingPointer(location, ARRAY_LENGTH_, MATRIX_STORAGE_CONVENTION_, reinterpret_cast<const UniformArgumentType *>(&value));
 }
 
+// Returns true iff a uniform block member with the given layout (as reported by glGetActiveUniformsiv)
+// has its elements, and the columns (or rows) of its matrices, packed exactly as in its C++ value, so
+// that the value can be copied into the block as is.
+template <GLenum GL_TYPE_, size_t ARRAY_LENGTH_, MatrixStorageConvention MATRIX_STORAGE_CONVENTION_>
+typename std::enable_if<!UniformTraits<GL_TYPE_>::IS_MATRIX_TYPE,bool>::type UniformizedInterface_IsPackedInBlock (GLint array_stride, GLint matrix_stride, GLint is_row_major) {
+  typedef typename UniformTraits<GL_TYPE_>::UniformArgumentType UniformArgumentType;
+  return ARRAY_LENGTH_ == 1 || array_stride == GLint(UniformTraits<GL_TYPE_>::COMPONENT_COUNT*sizeof(UniformArgumentType));
+}
+
+template <GLenum GL_TYPE_, size_t ARRAY_LENGTH_, MatrixStorageConvention MATRIX_STORAGE_CONVENTION_>
+typename std::enable_if<UniformTraits<GL_TYPE_>::IS_MATRIX_TYPE,bool>::type UniformizedInterface_IsPackedInBlock (GLint array_stride, GLint matrix_stride, GLint is_row_major) {
+  typedef UniformTraits<GL_TYPE_> Traits;
+  typedef typename Traits::UniformArgumentType UniformArgumentType;
+  const bool row_major = MATRIX_STORAGE_CONVENTION_ == ROW_MAJOR;
+  if ((is_row_major != 0) != row_major) {
+    return false;
+  }
+  const size_t vector_length = row_major ? Traits::COLUMN_COUNT : Traits::ROW_COUNT;
+  return matrix_stride == GLint(vector_length*sizeof(UniformArgumentType)) &&
+         (ARRAY_LENGTH_ == 1 || array_stride == GLint(Traits::COMPONENT_COUNT*sizeof(UniformArgumentType)));
+}
+
 } // end of namespace Internal
 } // end of namespace GL
 } // end of namespace Leap
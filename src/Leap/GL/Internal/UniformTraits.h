@@ -49,6 +49,8 @@ template <GLenum GL_TYPE_> struct UniformTraits { static const bool IS_DEFINED =
     typedef GLtype_ GLtype; \
     typedef GLtype_ UniformArgumentType; \
     static const size_t COMPONENT_COUNT = ROWS_*COLUMNS_; \
+    static const size_t ROW_COUNT = ROWS_; \
+    static const size_t COLUMN_COUNT = COLUMNS_; \
     static void UploadUsingPointer (GLint location, GLsizei count, MatrixStorageConvention matrix_storage_convention, const UniformArgumentType *value) { \
       glUniformMatrixv(location, count, matrix_storage_convention == MatrixStorageConvention::ROW_MAJOR ? GL_TRUE : GL_FALSE, value); \
     } \
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "Leap/GL/GLHeaders.h" // convenience header for cross-platform GL includes
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace Leap {
+namespace GL {
+// The contents of the Internal namespace are not intended to be used publicly, and provide
+// no guarantee as to the stability of their API.  The classes and functions are used
+// internally in the implementation of the publicly-presented classes.
+namespace Internal {
+
+// Hashes the bytes of an object, 8 at a time.  Vertices are compared bytewise (as Mesh always
+// has), so hashing the bytes is consistent with equality.
+template <typename T_>
+uint64_t HashBytes (const T_ &object) {
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&object);
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= sizeof(T_); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(uint64_t));
+    hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 29;
+  }
+  for (; i < sizeof(T_); ++i) {
+    hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+  }
+  // Final avalanche (from MurmurHash3's fmix64), so that the low bits used to pick slots are well mixed.
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+// An open-addressing (linear probing) set of vertex indices, which maps each vertex to the
+// index of the first equal vertex inserted.  The table never grows, so it must be constructed
+// with an upper bound on the number of distinct vertices.
+template <typename Vertex_>
+class VertexHashTable {
+public:
+
+  VertexHashTable (const Vertex_ *vertices, size_t max_entries)
+    : m_vertices(vertices)
+  {
+    size_t capacity = 16;
+    while (capacity < 2*max_entries) {
+      capacity *= 2;
+    }
+    m_mask = capacity - 1;
+    m_slots.resize(capacity);
+  }
+
+  // Returns the index of the first inserted vertex equal to m_vertices[index], inserting index
+  // if there is no such vertex.  hash must be HashBytes(m_vertices[index]).
+  GLuint FindOrInsert (GLuint index, uint64_t hash) {
+    const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    for (size_t slot = static_cast<size_t>(hash) & m_mask; ; slot = (slot + 1) & m_mask) {
+      Slot &s = m_slots[slot];
+      if (s.index == EMPTY) {
+        s.tag = tag;
+        s.index = index;
+        return index;
+      }
+      if (s.tag == tag && std::memcmp(&m_vertices[s.index], &m_vertices[index], sizeof(Vertex_)) == 0) {
+        return s.index;
+      }
+    }
+  }
+
+private:
+
+  static const GLuint EMPTY = ~GLuint(0);
+
+  struct Slot {
+    Slot () : tag(0), index(EMPTY) { }
+    // The high half of the hash, checked before comparing the vertices themselves.
+    uint32_t tag;
+    GLuint index;
+  };
+
+  const Vertex_ *m_vertices;
+  size_t m_mask;
+  std::vector<Slot> m_slots;
+};
+
+// Runs function(begin, end) on thread_count contiguous pieces of [0, count), one per thread.
+template <typename Function_>
+void ParallelForRanges (size_t count, size_t thread_count, const Function_ &function) {
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count - 1);
+  const size_t piece = (count + thread_count - 1) / thread_count;
+  for (size_t t = 1; t < thread_count; ++t) {
+    const size_t begin = std::min(count, t*piece);
+    const size_t end = std::min(count, begin + piece);
+    threads.emplace_back([&function, begin, end] () { function(begin, end); });
+  }
+  function(0, std::min(count, piece));
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+}
+
+// Below this many vertices, DeduplicateVertices doesn't bother with threads.
+static const size_t PARALLEL_DEDUPLICATION_THRESHOLD = 1 << 16;
+
+// As below, using at most thread_count threads.  The result doesn't depend on thread_count.
+//
+// With several threads, every vertex is hashed once, then the vertex indices are bucketed by
+// the top bits of their hashes with a counting sort (each thread counting and then scattering
+// its own range of vertices, so each bucket stays in ascending order).  Equal vertices have
+// equal hashes, so each bucket can be deduplicated by its own thread with its own table, which
+// finds the first occurrence of each vertex.  Only the final numbering is serial.
+template <typename Vertex_>
+void DeduplicateVertices (const Vertex_ *vertices,
+                          size_t vertex_count,
+                          std::vector<Vertex_> &unique_vertices,
+                          std::vector<GLuint> &indices,
+                          size_t thread_count)
+{
+  unique_vertices.clear();
+  indices.clear();
+  indices.reserve(vertex_count);
+
+  if (vertex_count < PARALLEL_DEDUPLICATION_THRESHOLD || thread_count <= 1) {
+    VertexHashTable<Vertex_> table(vertices, vertex_count);
+    // Maps the index of each first occurrence to its index in unique_vertices.
+    std::vector<GLuint> unique_index_of(vertex_count);
+    for (size_t i = 0; i < vertex_count; ++i) {
+      const GLuint first = table.FindOrInsert(static_cast<GLuint>(i), HashBytes(vertices[i]));
+      if (first == i) {
+        unique_index_of[i] = static_cast<GLuint>(unique_vertices.size());
+        unique_vertices.push_back(vertices[i]);
+      }
+      indices.push_back(unique_index_of[first]);
+    }
+    return;
+  }
+
+  // One bucket per thread, rounded up to a power of two so that a bucket is a hash prefix.
+  int bucket_bits = 0;
+  while ((size_t(1) << bucket_bits) < thread_count) {
+    ++bucket_bits;
+  }
+  const size_t bucket_count = size_t(1) << bucket_bits;
+  auto BucketOf = [bucket_bits] (uint64_t hash) { return static_cast<size_t>(hash >> (64 - bucket_bits)); };
+
+  // Hash everything, and count each range's vertices per bucket.
+  std::vector<uint64_t> hashes(vertex_count);
+  std::vector<size_t> bucket_offsets(thread_count*bucket_count, 0); // [range][bucket]
+  const size_t piece = (vertex_count + thread_count - 1) / thread_count;
+  ParallelForRanges(vertex_count, thread_count, [&] (size_t begin, size_t end) {
+    size_t *counts = &bucket_offsets[(begin / piece)*bucket_count];
+    for (size_t i = begin; i < end; ++i) {
+      hashes[i] = HashBytes(vertices[i]);
+      ++counts[BucketOf(hashes[i])];
+    }
+  });
+
+  // Turn the counts into each range's starting offset in each bucket.
+  std::vector<size_t> bucket_begin(bucket_count + 1, 0);
+  size_t offset = 0;
+  for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+    bucket_begin[bucket] = offset;
+    for (size_t range = 0; range < thread_count; ++range) {
+      const size_t count = bucket_offsets[range*bucket_count + bucket];
+      bucket_offsets[range*bucket_count + bucket] = offset;
+      offset += count;
+    }
+  }
+  bucket_begin[bucket_count] = offset;
+
+  std::vector<GLuint> bucketed(vertex_count);
+  ParallelForRanges(vertex_count, thread_count, [&] (size_t begin, size_t end) {
+    size_t *offsets = &bucket_offsets[(begin / piece)*bucket_count];
+    for (size_t i = begin; i < end; ++i) {
+      bucketed[offsets[BucketOf(hashes[i])]++] = static_cast<GLuint>(i);
+    }
+  });
+
+  std::vector<GLuint> first_occurrence(vertex_count);
+  ParallelForRanges(bucket_count, thread_count, [&] (size_t begin, size_t end) {
+    for (size_t bucket = begin; bucket < end; ++bucket) {
+      VertexHashTable<Vertex_> table(vertices, bucket_begin[bucket + 1] - bucket_begin[bucket]);
+      for (size_t j = bucket_begin[bucket]; j < bucket_begin[bucket + 1]; ++j) {
+        const GLuint i = bucketed[j];
+        first_occurrence[i] = table.FindOrInsert(i, hashes[i]);
+      }
+    }
+  });
+
+  // Number the distinct vertices in order of first appearance.  first_occurrence[i] <= i, so
+  // it has been numbered by the time it is needed.
+  std::vector<GLuint> unique_index_of(vertex_count);
+  for (size_t i = 0; i < vertex_count; ++i) {
+    const GLuint first = first_occurrence[i];
+    if (first == i) {
+      unique_index_of[i] = static_cast<GLuint>(unique_vertices.size());
+      unique_vertices.push_back(vertices[i]);
+    }
+    indices.push_back(unique_index_of[first]);
+  }
+}
+
+// Reduces vertices to the distinct ones, in order of first appearance, and produces the index
+// array which refers to them (so that unique_vertices[indices[i]] == vertices[i]).  Large inputs
+// are deduplicated on up to 8 threads (see above).
+template <typename Vertex_>
+void DeduplicateVertices (const Vertex_ *vertices,
+                          size_t vertex_count,
+                          std::vector<Vertex_> &unique_vertices,
+                          std::vector<GLuint> &indices)
+{
+  const size_t thread_count = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), 8);
+  DeduplicateVertices(vertices, vertex_count, unique_vertices, indices, thread_count);
+}
+
+} // end of namespace Internal
+} // end of namespace GL
+} // end of namespace Leap
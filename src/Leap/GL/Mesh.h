@@ -3,10 +3,14 @@
 #include <cstdint>
 #include "Leap/GL/BufferObject.h"
 #include "Leap/GL/Error.h"
+#include "Leap/GL/Internal/VertexDeduplication.h"
 #include "Leap/GL/MeshException.h"
 #include "Leap/GL/ResourceBase.h"
+#include "Leap/GL/StateCache.h"
 #include "Leap/GL/VertexBufferObject.h"
-#include <map>
+#include <algorithm>
+#include <limits>
+#include <utility>
 #include <vector>
 
 namespace Leap {
@@ -20,6 +24,17 @@ namespace GL {
 /// The UploadIntermediateVertices method will compute a map of unique vertices and compute the index array
 /// which will be used in the Draw method (supplied to glDrawElements).
 ///
+/// The unique vertices are found by hashing; meshes of 65536 or more vertices are split by hash
+/// and deduplicated on up to 8 threads (see Internal::DeduplicateVertices).  Vertices are
+/// considered equal iff they are bytewise equal.  Callers which already have an index array can
+/// pass it to Initialize along with the vertices, which skips deduplication altogether (see also
+/// the PushIndexed* methods of MeshAssembler).  Either way, the indices are stored as GLushort if
+/// there are few enough vertices, which halves the size of the index buffer; see IndexType.
+///
+/// Where vertex array objects are available (see UsesVertexArrays), the Mesh keeps one for each
+/// set of attribute locations it is bound with (i.e. one per shader program, in practice), so that
+/// after the first Bind, binding the Mesh is a single glBindVertexArray.
+///
 /// This class inherits ResourceBase and thereby follows the resource conventions specified there.
 ///
 /// The @c MeshAssembler class can be used to construct mesh vertex data in a convenient way.
@@ -34,15 +49,28 @@ public:
   /// @details It will be necessary to call Initialize on this object to use it.
   Mesh ()
     : m_draw_mode(GL_INVALID_ENUM)
+    , m_vertex_count(0)
     , m_index_count(0)
+    , m_index_type(GL_UNSIGNED_INT)
   { }
   /// @brief Convenience constructor that will call Initialize with the given arguments.
   Mesh (const VertexAttributes *vertex_attribute_data, size_t vertex_count, GLenum draw_mode)
     : m_draw_mode(GL_INVALID_ENUM)
+    , m_vertex_count(0)
     , m_index_count(0)
+    , m_index_type(GL_UNSIGNED_INT)
   {
     Initialize(vertex_attribute_data, vertex_count, draw_mode);
   }
+  /// @brief Convenience constructor that will call Initialize with the given (pre-indexed) arguments.
+  Mesh (const VertexAttributes *vertex_attribute_data, size_t vertex_count, const GLuint *index_data, size_t index_count, GLenum draw_mode)
+    : m_draw_mode(GL_INVALID_ENUM)
+    , m_vertex_count(0)
+    , m_index_count(0)
+    , m_index_type(GL_UNSIGNED_INT)
+  {
+    Initialize(vertex_attribute_data, vertex_count, index_data, index_count, draw_mode);
+  }
   /// @brief Destructor will call Shutdown.
   ~Mesh () {
     Shutdown();
@@ -60,6 +88,36 @@ public:
     }
     return m_draw_mode;
   }
+  /// @brief Returns the type of the elements of the index buffer, GL_UNSIGNED_SHORT if the Mesh has
+  /// at most MAX_SHORT_INDEXED_VERTEX_COUNT vertices, and GL_UNSIGNED_INT otherwise.
+  /// @details Throws MeshException if !IsInitialized.
+  GLenum IndexType () const {
+    if (!IsInitialized()) {
+      throw MeshException("A Mesh object has no IndexType value if !IsInitialized.");
+    }
+    return m_index_type;
+  }
+
+  /// @brief Returns the number of bytes of GL buffer storage (vertices and indices) held by this Mesh.
+  /// @details Throws MeshException if !IsInitialized.
+  size_t BufferSize () const {
+    if (!IsInitialized()) {
+      throw MeshException("A Mesh object has no BufferSize value if !IsInitialized.");
+    }
+    return m_vertex_count*sizeof(VertexAttributes) + static_cast<size_t>(m_index_buffer.Size());
+  }
+
+  /// @brief The largest vertex count for which the indices are stored as GLushort.
+  static const size_t MAX_SHORT_INDEXED_VERTEX_COUNT = size_t(std::numeric_limits<GLushort>::max()) + 1;
+
+  /// @brief Returns true iff the current GL context supports vertex array objects, which Bind then uses.
+  static bool UsesVertexArrays () {
+    return GLEW_VERSION_3_0 || GLEW_ARB_vertex_array_object;
+  }
+  /// @brief Returns true iff the current GL context supports DrawInstanced.
+  static bool SupportsInstancedDraw () {
+    return GLEW_VERSION_3_1 || GLEW_ARB_draw_instanced || GLEW_ARB_instanced_arrays;
+  }
 
   // TODO: think about if these functions really belong here, or if the user should call the VBO and
   // index buffer bind methods and the draw methods themselves.
@@ -70,11 +128,19 @@ public:
   /// here.  Specifying -1 for any individual attribute location will cause that attribute to
   /// go unused -- this allows shaders that don't have all the attributes in this Mesh to still
   /// be usable.
-  // TODO: write about what GL operations actually happen.
+  ///
+  /// If UsesVertexArrays(), this binds the vertex array object for attribute_locations, which is
+  /// created (calling glEnableVertexAttribArray and glVertexAttribPointer, and binding the index
+  /// buffer into it) the first time these locations are used.  Otherwise, the attribute arrays
+  /// are enabled and the buffers bound on every call.
   void Bind (typename VBO::AttributeLocations &attribute_locations) const {
     if (!IsInitialized()) {
       throw MeshException("Can't Bind a Mesh if it !IsInitialized.");
     }
+    if (UsesVertexArrays()) {
+      BindVertexArray(attribute_locations);
+      return;
+    }
     // This calls glEnableVertexAttribArray and glVertexAttribPointer on the relevant things.
     m_vertex_buffer.Enable(attribute_locations);
     m_index_buffer.Bind();
@@ -84,15 +150,36 @@ public:
     if (!IsInitialized()) {
       throw MeshException("Can't Draw a Mesh if it !IsInitialized.");
     }
-    THROW_UPON_GL_ERROR(glDrawElements(m_draw_mode, m_index_count, GL_UNSIGNED_INT, 0));
+    THROW_UPON_GL_ERROR(glDrawElements(m_draw_mode, m_index_count, m_index_type, 0));
+  }
+  /// @brief Draws instance_count instances of a bound Mesh by calling glDrawElementsInstanced.
+  /// @details The per-instance vertex attributes (those with a nonzero glVertexAttribDivisor)
+  /// must be set up by the caller.  Requires OpenGL 3.1, ARB_draw_instanced or ARB_instanced_arrays
+  /// (see SupportsInstancedDraw).
+  void DrawInstanced (GLsizei instance_count) const {
+    if (!IsInitialized()) {
+      throw MeshException("Can't Draw a Mesh if it !IsInitialized.");
+    }
+    if (GLEW_VERSION_3_1) {
+      THROW_UPON_GL_ERROR(glDrawElementsInstanced(m_draw_mode, m_index_count, m_index_type, 0, instance_count));
+    } else if (GLEW_ARB_draw_instanced || GLEW_ARB_instanced_arrays) {
+      THROW_UPON_GL_ERROR(glDrawElementsInstancedARB(m_draw_mode, m_index_count, m_index_type, 0, instance_count));
+    } else {
+      throw MeshException("DrawInstanced requires OpenGL 3.1, ARB_draw_instanced or ARB_instanced_arrays.");
+    }
   }
   /// @brief Unbinds this mesh.
-  /// @details Must pass in the same attribute_locations as to the call to Bind.
-  // TODO: write about what GL operations actually happen.
+  /// @details Must pass in the same attribute_locations as to the call to Bind.  If UsesVertexArrays(),
+  /// this just binds vertex array 0 (see StateCache::DeferredUnbindScope), leaving the vertex array
+  /// object's attribute arrays enabled.
   void Unbind (typename VBO::AttributeLocations &attribute_locations) const {
     if (!IsInitialized()) {
       throw MeshException("Can't Unbind a Mesh if it !IsInitialized.");
     }
+    if (UsesVertexArrays()) {
+      StateCache::Current().BindVertexArray(0);
+      return;
+    }
     m_index_buffer.Unbind();
     // This calls glDisableVertexAttribArray on the relevant things.
     m_vertex_buffer.Disable(attribute_locations);
@@ -102,7 +189,27 @@ private:
 
   friend class ResourceBase<Mesh<AttributeTypes...>>;
 
+  // Binds the vertex array object for the given attribute locations, creating it if necessary.
+  void BindVertexArray (const typename VBO::AttributeLocations &attribute_locations) const {
+    StateCache &state_cache = StateCache::Current();
+    for (const auto &vertex_array : m_vertex_arrays) {
+      if (vertex_array.first == attribute_locations) {
+        state_cache.BindVertexArray(vertex_array.second);
+        return;
+      }
+    }
+    GLuint vertex_array = 0;
+    THROW_UPON_GL_ERROR(glGenVertexArrays(1, &vertex_array));
+    m_vertex_arrays.emplace_back(attribute_locations, vertex_array);
+    state_cache.BindVertexArray(vertex_array);
+    // This calls glEnableVertexAttribArray and glVertexAttribPointer on the relevant things, which
+    // the vertex array object records, along with the index buffer binding.
+    m_vertex_buffer.Enable(attribute_locations);
+    m_index_buffer.Bind();
+  }
+
   bool IsInitialized_Implementation () const { return m_draw_mode != GL_INVALID_ENUM; }
+  // Deduplicates the given vertices, and uploads the distinct ones along with the indices referring to them.
   void Initialize_Implementation (const VertexAttributes *vertex_attribute_data, size_t vertex_count, GLenum draw_mode) {
     if (vertex_attribute_data == nullptr) {
       throw MeshException("vertex_attribute_data must be a valid pointer.");
@@ -110,7 +217,32 @@ private:
     if (vertex_count == 0) {
       throw MeshException("vertex_count must be positive.");
     }
+    if (vertex_count > std::numeric_limits<GLuint>::max()) {
+      throw MeshException("vertex_count must be representable as a GLuint.");
+    }
+    CheckDrawMode(draw_mode);
+
+    std::vector<VertexAttributes> unique_vertex_attributes;
+    std::vector<GLuint> indices;
+    Internal::DeduplicateVertices(vertex_attribute_data, vertex_count, unique_vertex_attributes, indices);
+    Upload(unique_vertex_attributes.data(), unique_vertex_attributes.size(), indices.data(), indices.size(), draw_mode);
+  }
+  // Uploads the vertices and indices as given, for callers whose vertices are already indexed.
+  void Initialize_Implementation (const VertexAttributes *vertex_attribute_data, size_t vertex_count, const GLuint *index_data, size_t index_count, GLenum draw_mode) {
+    if (vertex_attribute_data == nullptr || index_data == nullptr) {
+      throw MeshException("vertex_attribute_data and index_data must be valid pointers.");
+    }
+    if (vertex_count == 0 || index_count == 0) {
+      throw MeshException("vertex_count and index_count must be positive.");
+    }
+    if (std::any_of(index_data, index_data + index_count, [vertex_count] (GLuint index) { return index >= vertex_count; })) {
+      throw MeshException("Every element of index_data must be less than vertex_count.");
+    }
+    CheckDrawMode(draw_mode);
 
+    Upload(vertex_attribute_data, vertex_count, index_data, index_count, draw_mode);
+  }
+  static void CheckDrawMode (GLenum draw_mode) {
     switch (draw_mode) {
       case GL_POINTS:
       case GL_LINE_STRIP:
@@ -123,55 +255,44 @@ private:
       case GL_TRIANGLES:
       case GL_TRIANGLE_STRIP_ADJACENCY:
       case GL_TRIANGLES_ADJACENCY:
-        m_draw_mode = draw_mode;
         break;
       default:
         throw MeshException("Invalid draw mode -- must be one of GL_POINTS, GL_LINE_STRIP, GL_LINE_LOOP, GL_LINES, GL_LINE_STRIP_ADJACENCY, GL_LINES_ADJACENCY, GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN, GL_TRIANGLES, GL_TRIANGLE_STRIP_ADJACENCY and GL_TRIANGLES_ADJACENCY (see OpenGL 3.3 docs for glDrawElements).");
     }
-
-    // TODO: move into the function which uses this.
-    struct VertexAttributesCompare {
-      bool operator () (const VertexAttributes &lhs, const VertexAttributes &rhs) const {
-        return memcmp(reinterpret_cast<const void *>(&lhs), reinterpret_cast<const void *>(&rhs), sizeof(VertexAttributes)) < 0;
-      }
-    };
-    typedef std::map<VertexAttributes,GLuint,VertexAttributesCompare> VertexIndexMap;
-
-    // Eliminate duplicate vertices using a temporary map.
-    VertexIndexMap vertex_attributes_index_map;
-    std::vector<GLuint> indices;
-    std::vector<VertexAttributes> unique_vertex_attributes;
-    // This loop will reduce vertex_attribute_data down into unique_vertex_attributes.
-    for (size_t i = 0; i < vertex_count; ++i) {
-      const VertexAttributes &vertex_attributes = vertex_attribute_data[i];
-      auto mapped_vertex_attribute = vertex_attributes_index_map.find(vertex_attributes);
-      // If the current vertex is not in the vbo map already, add it.
-      if (mapped_vertex_attribute == vertex_attributes_index_map.end()) {
-        GLuint new_index = static_cast<GLuint>(vertex_attributes_index_map.size());
-        indices.push_back(new_index);
-        unique_vertex_attributes.push_back(vertex_attributes);
-        vertex_attributes_index_map[vertex_attributes] = new_index;
-      } else { // Otherwise, add the existing vertex's index.
-        indices.push_back(mapped_vertex_attribute->second);
-      }
-    }
-
+  }
+  void Upload (const VertexAttributes *vertex_attribute_data, size_t vertex_count, const GLuint *index_data, size_t index_count, GLenum draw_mode) {
     // TODO: correct exception handling with cleanup
 
-    m_vertex_buffer.Initialize(unique_vertex_attributes.data(), unique_vertex_attributes.size(), GL_STATIC_DRAW);
+    m_vertex_buffer.Initialize(vertex_attribute_data, vertex_count, GL_STATIC_DRAW);
+    m_vertex_count = vertex_count;
 
-    m_index_count = indices.size();
+    m_index_count = index_count;
 
     m_index_buffer.Initialize(GL_ELEMENT_ARRAY_BUFFER);
     m_index_buffer.Bind();
-    // If only the vertex attribute data is going to change (and not the )
-    m_index_buffer.BufferData(static_cast<const void *>(indices.data()), indices.size()*sizeof(GLuint), GL_STATIC_DRAW);
+    if (vertex_count <= MAX_SHORT_INDEXED_VERTEX_COUNT) {
+      const std::vector<GLushort> short_indices(index_data, index_data + index_count);
+      m_index_buffer.BufferData(static_cast<const void *>(short_indices.data()), index_count*sizeof(GLushort), GL_STATIC_DRAW);
+      m_index_type = GL_UNSIGNED_SHORT;
+    } else {
+      m_index_buffer.BufferData(static_cast<const void *>(index_data), index_count*sizeof(GLuint), GL_STATIC_DRAW);
+      m_index_type = GL_UNSIGNED_INT;
+    }
     m_index_buffer.Unbind();
+
+    m_draw_mode = draw_mode;
   }
   void Shutdown_Implementation () {
+    for (const auto &vertex_array : m_vertex_arrays) {
+      glDeleteVertexArrays(1, &vertex_array.second);
+      StateCache::Current().ForgetVertexArray(vertex_array.second);
+    }
+    m_vertex_arrays.clear();
     m_draw_mode = GL_INVALID_ENUM;
     m_vertex_buffer.Shutdown();
+    m_vertex_count = 0;
     m_index_count = 0;
+    m_index_type = GL_UNSIGNED_INT;
     m_index_buffer.Shutdown();
   }
 
@@ -179,11 +300,17 @@ private:
   GLenum m_draw_mode;
   // This is the vertex buffer object for uploaded vertex attribute data.
   VBO m_vertex_buffer;
+  // The number of vertices in m_vertex_buffer.
+  size_t m_vertex_count;
   // This is the number of indices used to pass to glDrawElements when drawing the VBO.
-  // This could be derived from m_index_buffer.Size() / sizeof(GLuint).
+  // This could be derived from m_index_buffer.Size() and m_index_type.
   size_t m_index_count;
+  // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, depending on the vertex count.
+  GLenum m_index_type;
   // This is the buffer containing the index elements.
   BufferObject m_index_buffer;
+  // The vertex array objects created by Bind, keyed by the attribute locations they were created for.
+  mutable std::vector<std::pair<typename VBO::AttributeLocations,GLuint>> m_vertex_arrays;
 };
 
 } // end of namespace GL
@@ -14,6 +14,11 @@ namespace GL {
 /// rendering.  A MeshAssembler object has a vector of vertex attributes which are collected by the
 /// Push* methods, or can be accessed/modified directly using the Vertices methods.
 ///
+/// Alternatively, a MeshAssembler can be used in indexed mode, where each distinct vertex is pushed
+/// once via PushIndexedVertex, and the primitives are pushed as indices via the other PushIndexed*
+/// methods.  This saves Mesh from having to find the distinct vertices itself.  The two modes can't
+/// be mixed: the first vertex pushed decides which one the MeshAssembler is in (see IsIndexed).
+///
 /// This class inherits ResourceBase and thereby follows the resource conventions specified there.
 template <typename... AttributeTypes>
 class MeshAssembler : public ResourceBase<MeshAssembler<AttributeTypes...>> {
@@ -25,10 +30,12 @@ public:
   /// @details It will be necessary to call Initialize on this object to use it.
   MeshAssembler ()
     : m_draw_mode(GL_INVALID_ENUM)
+    , m_indexed(false)
   { }
   /// @brief Convenience constructor that will call Initialize with the given arguments.
   MeshAssembler (GLenum draw_mode)
     : m_draw_mode(GL_INVALID_ENUM)
+    , m_indexed(false)
   {
     Initialize(draw_mode);
   }
@@ -63,14 +70,27 @@ public:
     }
     return m_vertices;
   }
+  /// @brief Returns true iff vertices have been pushed via PushIndexedVertex (see MeshAssembler).
+  bool IsIndexed () const { return m_indexed; }
+  /// @brief Returns a const reference to the indices pushed by the PushIndexed* methods, or throws MeshException if !IsInitialized.
+  const std::vector<GLuint> &Indices () const {
+    if (!IsInitialized()) {
+      throw MeshException("MeshAssembler has no Indices value if !IsInitialized().");
+    }
+    return m_indices;
+  }
 
-  /// @brief Calls Initialize on the specified Mesh using the current vertices.
+  /// @brief Calls Initialize on the specified Mesh using the current vertices (and indices, if IsIndexed()).
   /// @details Note that the Mesh will be Shutdown if it IsInitialized.
   void InitializeMesh (Mesh<AttributeTypes...> &mesh) const {
     if (!IsInitialized()) {
       throw MeshException("Can't call InitializeMesh on a MeshAssembler object that !IsInitialized().");
     }
-    mesh.Initialize(m_vertices.data(), m_vertices.size(), m_draw_mode);
+    if (m_indexed) {
+      mesh.Initialize(m_vertices.data(), m_vertices.size(), m_indices.data(), m_indices.size(), m_draw_mode);
+    } else {
+      mesh.Initialize(m_vertices.data(), m_vertices.size(), m_draw_mode);
+    }
   }
 
   /// @brief Push a single vertex to the vertices vector.
@@ -82,6 +102,9 @@ public:
     if (!IsInitialized()) {
       throw MeshException("Can't push vertex data into a MeshAssembler that !IsInitialized().");
     }
+    if (m_indexed) {
+      throw MeshException("Can't push unindexed vertex data into a MeshAssembler that IsIndexed().");
+    }
     m_vertices.emplace_back(args...);
   }
   /// @brief Push two vertices which define a single line segment.
@@ -91,6 +114,9 @@ public:
     if (!IsInitialized()) {
       throw MeshException("Can't push vertex data into a MeshAssembler that !IsInitialized().");
     }
+    if (m_indexed) {
+      throw MeshException("Can't push unindexed vertex data into a MeshAssembler that IsIndexed().");
+    }
     if (m_draw_mode != GL_LINES) {
       throw MeshException("Mesh::PushLine is only defined if the draw mode is GL_LINES.");
     }
@@ -105,6 +131,9 @@ public:
     if (!IsInitialized()) {
       throw MeshException("Can't push vertex data into a MeshAssembler that !IsInitialized().");
     }
+    if (m_indexed) {
+      throw MeshException("Can't push unindexed vertex data into a MeshAssembler that IsIndexed().");
+    }
     if (m_draw_mode != GL_TRIANGLES) {
       throw MeshException("Mesh::PushTriangle is only defined if the draw mode is GL_TRIANGLES.");
     }
@@ -121,6 +150,9 @@ public:
     if (!IsInitialized()) {
       throw MeshException("Can't push vertex data into a MeshAssembler that !IsInitialized().");
     }
+    if (m_indexed) {
+      throw MeshException("Can't push unindexed vertex data into a MeshAssembler that IsIndexed().");
+    }
     if (m_draw_mode != GL_TRIANGLES) {
       throw MeshException("Mesh::PushQuad is only defined if the draw mode is GL_TRIANGLES.");
     }
@@ -142,6 +174,9 @@ public:
     if (!IsInitialized()) {
       throw MeshException("Can't push vertex data into a MeshAssembler that !IsInitialized().");
     }
+    if (m_indexed) {
+      throw MeshException("Can't push unindexed vertex data into a MeshAssembler that IsIndexed().");
+    }
     if (m_draw_mode != GL_LINES_ADJACENCY) {
       throw MeshException("Mesh::PushLineAdjacency is only defined if the draw mode is GL_LINES_ADJACENCY.");
     }
@@ -161,6 +196,9 @@ public:
     if (!IsInitialized()) {
       throw MeshException("Can't push vertex data into a MeshAssembler that !IsInitialized().");
     }
+    if (m_indexed) {
+      throw MeshException("Can't push unindexed vertex data into a MeshAssembler that IsIndexed().");
+    }
     if (m_draw_mode != GL_LINES) {
       throw MeshException("Mesh::PushTriangleAdjacency is only defined if the draw mode is GL_TRIANGLES_ADJACENCY.");
     }
@@ -172,6 +210,42 @@ public:
     m_vertices.emplace_back(v5);
   }
 
+  /// @brief Push a single vertex in indexed mode, returning its index for use in the other PushIndexed* methods.
+  /// @details This puts the MeshAssembler in indexed mode (see MeshAssembler), which is only
+  /// possible if no unindexed vertices have been pushed.
+  GLuint PushIndexedVertex (const VertexAttributes &v) {
+    if (!IsInitialized()) {
+      throw MeshException("Can't push vertex data into a MeshAssembler that !IsInitialized().");
+    }
+    if (!m_indexed && !m_vertices.empty()) {
+      throw MeshException("Can't push indexed vertex data into a MeshAssembler which has unindexed vertices.");
+    }
+    m_indexed = true;
+    m_vertices.emplace_back(v);
+    return static_cast<GLuint>(m_vertices.size() - 1);
+  }
+  /// @brief Push the indices of three vertices which define a single triangle.
+  /// @details This is to be used only when the draw mode is GL_TRIANGLES.  The indices must have
+  /// been returned by PushIndexedVertex.
+  void PushIndexedTriangle (GLuint i0, GLuint i1, GLuint i2) {
+    if (!IsInitialized()) {
+      throw MeshException("Can't push index data into a MeshAssembler that !IsInitialized().");
+    }
+    if (m_draw_mode != GL_TRIANGLES) {
+      throw MeshException("Mesh::PushIndexedTriangle is only defined if the draw mode is GL_TRIANGLES.");
+    }
+    m_indices.push_back(i0);
+    m_indices.push_back(i1);
+    m_indices.push_back(i2);
+  }
+  /// @brief Push the indices of four vertices which define two triangles and therefore a quadrilateral.
+  /// @details This is to be used only when the draw mode is GL_TRIANGLES.  The triangles are the
+  /// same as those pushed by PushQuad.
+  void PushIndexedQuad (GLuint i0, GLuint i1, GLuint i2, GLuint i3) {
+    PushIndexedTriangle(i0, i1, i2);
+    PushIndexedTriangle(i0, i2, i3);
+  }
+
 private:
 
   friend class ResourceBase<MeshAssembler<AttributeTypes...>>;
@@ -198,13 +272,18 @@ private:
   }
   void Shutdown_Implementation () {
     m_draw_mode = GL_INVALID_ENUM;
+    m_indexed = false;
     m_vertices.clear();
+    m_indices.clear();
   }
 
   // Indicates what geometric primitives the vertices are specifying (e.g. GL_TRIANGLES, GL_LINE_STRIP, etc).
   GLenum m_draw_mode;
   // This intermediate storage for vertex data as it is being generated, and may be cleared during upload.
   std::vector<VertexAttributes> m_vertices;
+  // True iff the vertices were pushed via PushIndexedVertex, in which case m_indices refers to them.
+  bool m_indexed;
+  std::vector<GLuint> m_indices;
 };
 
 } // end of namespace GL
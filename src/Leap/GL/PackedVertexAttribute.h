@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Leap/GL/GLHeaders.h"
+#include "Leap/GL/Internal/PackedVertexAttribute.h"
+
+namespace Leap {
+namespace GL {
+
+/// @brief A vertex attribute stored in a packed format, for use in VertexBufferObject (and so Mesh)
+/// alongside or instead of VertexAttribute.
+/// @details Where VertexAttribute stores exactly the type the shader sees (e.g. three GLfloats
+/// for a vec3), PackedVertexAttribute stores the value in a smaller format which GL unpacks
+/// when the vertices are fetched.  The format is named by the type enum PACKED_TYPE passed to
+/// glVertexAttribPointer:
+/// - GL_INT_2_10_10_10_REV: a signed, normalized 3-vector (e.g. a unit normal) in 4 bytes.
+///   Requires OpenGL 3.3 or ARB_vertex_type_2_10_10_10_rev.
+/// - GL_HALF_FLOAT: a 2-vector (e.g. a texture coordinate) in 4 bytes.  Requires OpenGL 3.0 or
+///   ARB_half_float_vertex.
+/// - GL_UNSIGNED_BYTE: a 4-vector with components in [0,1] (e.g. an RGBA color) in 4 bytes.
+///
+/// The value is packed upon construction, from any type whose components are accessible via
+/// operator [] (e.g. EigenTypes::Vector3f); out-of-range components are clamped.  Since the
+/// packing is lossy, the value isn't readable back.  See IsSupported.
+template <GLenum PACKED_TYPE>
+class PackedVertexAttribute {
+public:
+
+  /// @brief The type in which the packed value is stored.
+  typedef typename Internal::PackedVertexAttributeReflection<PACKED_TYPE>::Storage StorageType;
+  /// @brief The OpenGL enum specifying the packed format (passed to glVertexAttribPointer).
+  static const GLenum COMPONENT_TYPE_ENUM = PACKED_TYPE;
+  /// @brief The number of components which the shader receives.
+  static const GLint COMPONENT_COUNT = Internal::PackedVertexAttributeReflection<PACKED_TYPE>::COUNT;
+
+  /// @brief Default constructor does not initialize the storage.
+  PackedVertexAttribute () { }
+  /// @brief Packs the given value into this attribute.
+  template <typename T>
+  PackedVertexAttribute (const T &value)
+    : m_storage(Internal::PackedVertexAttributeReflection<PACKED_TYPE>::Pack(value))
+  { }
+
+  /// @brief Returns true iff the current GL context supports this packed format as a vertex attribute.
+  static bool IsSupported () {
+    return Internal::PackedVertexAttributeReflection<PACKED_TYPE>::IsSupported();
+  }
+
+  /// @brief Enable the vertex attribute array for the given attribute location and set the vertex attribute pointer.
+  /// @details As in VertexAttribute::Enable, specifying -1 for location indicates that this
+  /// attribute should not be used.
+  static void Enable (GLint location, GLsizei stride, GLsizei offset) {
+    if (location != -1) {
+      glEnableVertexAttribArray(location);
+      glVertexAttribPointer(location, COMPONENT_COUNT, COMPONENT_TYPE_ENUM, Internal::PackedVertexAttributeReflection<PACKED_TYPE>::NORMALIZED, stride, reinterpret_cast<void*>(offset));
+    }
+  }
+  /// @brief Disables the vertex attribute array for the given attribute location.
+  /// @details As in @c Enable, only does anything if location is not -1.
+  static void Disable (GLint location) {
+    if (location != -1) {
+      glDisableVertexAttribArray(location);
+    }
+  }
+
+private:
+
+  StorageType m_storage;
+};
+
+} // end of namespace GL
+} // end of namespace Leap
@@ -1,6 +1,9 @@
 #include "stdafx.h"
 #include "Leap/GL/Shader.h"
 
+#include <algorithm>
+#include <cstring>
+
 // #include <iostream> // TEMP
 
 namespace Leap {
@@ -215,6 +218,22 @@ void Shader::Initialize_Implementation (const std::string &vertex_shader_source,
     }
   }
 
+  // Size the uniform shadow to cover the active uniforms.  Linking resets all uniforms, so every
+  // entry starts out unknown.  Locations are small in practice; should a driver hand out huge
+  // ones, those uniforms just go without a shadow.
+  {
+    static const GLint MAX_SHADOWED_LOCATION = 1023;
+    GLint max_location = -1;
+    for (const auto &it : m_active_uniform_info_map) {
+      const VarInfo &info = it.second;
+      if (info.Location() <= MAX_SHADOWED_LOCATION) {
+        max_location = std::max(max_location, info.Location());
+      }
+    }
+    m_uniform_shadow.clear();
+    m_uniform_shadow.resize(static_cast<size_t>(max_location + 1));
+  }
+
   // Populate the attribute map.
   {
     GLint active_attribs = 0;
@@ -241,13 +260,46 @@ void Shader::Initialize_Implementation (const std::string &vertex_shader_source,
   }
 }
 
+bool Shader::UpdateUniformShadow (GLint location, const void *data, size_t size) const {
+  if (location == -1) {
+    ++UploadStats().skipped;
+    return false;
+  }
+  if (location < 0 || static_cast<size_t>(location) >= m_uniform_shadow.size()) {
+    ++UploadStats().uploaded;
+    return true;
+  }
+  std::vector<uint8_t> &shadow = m_uniform_shadow[location];
+  if (shadow.size() == size && memcmp(shadow.data(), data, size) == 0) {
+    ++UploadStats().skipped;
+    return false;
+  }
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  shadow.assign(bytes, bytes + size);
+  ++UploadStats().uploaded;
+  return true;
+}
+
+void Shader::InvalidateUniformShadow (GLint location) const {
+  if (location >= 0 && static_cast<size_t>(location) < m_uniform_shadow.size()) {
+    m_uniform_shadow[location].clear();
+  }
+}
+
+Shader::UniformUploadStats &Shader::UploadStats () {
+  static UniformUploadStats stats = { 0, 0 };
+  return stats;
+}
+
 void Shader::Shutdown_Implementation () {
   glDeleteProgram(m_program_handle);
+  StateCache::Current().ForgetProgram(m_program_handle);
   glDeleteShader(m_vertex_shader);
   glDeleteShader(m_fragment_shader);
   m_program_handle = 0;
   m_vertex_shader = 0;
   m_fragment_shader = 0;
+  m_uniform_shadow.clear();
 }
 
 } // end of namespace GL
@@ -13,6 +13,7 @@
 #include "Leap/GL/Internal/UniformUploader.h"
 #include "Leap/GL/ResourceBase.h"
 #include "Leap/GL/ShaderException.h"
+#include "Leap/GL/StateCache.h"
 
 namespace Leap {
 namespace GL {
@@ -102,11 +103,12 @@ public:
     if (!IsInitialized()) {
       throw ShaderException("Can't Bind a Shader that !IsInitialized().");
     }
-    THROW_UPON_GL_ERROR(glUseProgram(m_program_handle));
+    StateCache::Current().UseProgram(m_program_handle);
   }
   /// @brief This [static] method should be called when no shader program should be used.
+  /// @details Within a StateCache::DeferredUnbindScope, the program is only unbound at the end of the scope.
   static void Unbind () {
-    THROW_UPON_GL_ERROR(glUseProgram(0));
+    StateCache::Current().UseProgram(0);
   }
   /// @brief Returns the currently bound shader program (the integer handle generated by OpenGL).
   /// @details This should only generate a GL error if it is called between glBegin and glEnd.
@@ -152,11 +154,14 @@ public:
   /// @brief Returns the location of the requested attribute (its handle into the GL apparatus) or -1 if not found.
   /// @details The -1 return value is what is used by the glUniform* functions as a sentinel value for "this
   /// uniform is not found, so do nothing silently".  This shader does not need to be bound for this call to succeed.
+  /// The locations are looked up in ActiveAttributeInfoMap, which is populated when the program is linked,
+  /// so this doesn't call glGetAttribLocation.
   GLint LocationOfAttribute (const std::string &name) const {
     if (!IsInitialized()) {
       throw ShaderException("Can't call LocationOfUniform on a Shader that !IsInitialized().");
     }
-    return glGetAttribLocation(m_program_handle, name.c_str());
+    auto it = m_active_attribute_info_map.find(name);
+    return it != m_active_attribute_info_map.end() ? it->second.Location() : -1;
   }
 
   /// @brief Uploads a uniform of type GL_TYPE_ to given location, or does nothing if location is -1.
@@ -187,7 +192,10 @@ public:
     if (!IsInitialized()) {
       throw ShaderException("Can't call [the name version of] UploadUniform on a Shader that !IsInitialized().");
     }
-    Internal::UniformUploader<GL_TYPE_>::Upload(LocationOfUniform(name), args...);
+    const GLint location = LocationOfUniform(name);
+    Internal::UniformUploader<GL_TYPE_>::Upload(location, args...);
+    InvalidateUniformShadow(location);
+    ++UploadStats().uploaded;
   }
   /// @brief Uploads an array of uniforms of base type GL_TYPE_ and array length ARRAY_LENGTH_ to given location,
   /// or does nothing if location is -1.
@@ -213,9 +221,35 @@ public:
     if (!IsInitialized()) {
       throw ShaderException("Can't call [the name version of] UploadUniformArray on a Shader that !IsInitialized().");
     }
-    Internal::UniformUploader<GL_TYPE_>::template UploadArray<ARRAY_LENGTH_>(LocationOfUniform(name), args...);
+    const GLint location = LocationOfUniform(name);
+    Internal::UniformUploader<GL_TYPE_>::template UploadArray<ARRAY_LENGTH_>(location, args...);
+    InvalidateUniformShadow(location);
+    ++UploadStats().uploaded;
   }
 
+  /// @brief Decides whether a uniform value needs to be uploaded, using a copy of the values last
+  /// uploaded to this shader program.
+  /// @details Returns false if location is -1 or if the size bytes at data are the same as those
+  /// last recorded for location; otherwise records them and returns true, in which case the caller
+  /// must upload the value.  This is how ShaderFrontend skips redundant glUniform* calls.  The copy
+  /// is only valid as long as the program's uniforms are changed through ShaderFrontend or the name
+  /// versions of UploadUniform and UploadUniformArray (which invalidate it); anything uploading by
+  /// location directly must call InvalidateUniformShadow.
+  bool UpdateUniformShadow (GLint location, const void *data, size_t size) const;
+  /// @brief Forgets the recorded value of the uniform at location, so that the next
+  /// UpdateUniformShadow for it returns true.
+  void InvalidateUniformShadow (GLint location) const;
+
+  /// @brief Running totals of the glUniform* calls made through ShaderFrontend and the name versions
+  /// of UploadUniform and UploadUniformArray (uploaded), and of those avoided because the value was
+  /// unchanged or the uniform isn't active (skipped).
+  struct UniformUploadStats {
+    uint64_t uploaded;
+    uint64_t skipped;
+  };
+  /// @brief Returns the totals for all shader programs, which may be reset by the caller.
+  static UniformUploadStats &UploadStats ();
+
   // Returns (enum_name_string, type_name_string) for the given shader variable type.  Throws an
   // error if that type is not a shader variable type.
   /// @brief Returns the GLSL variable type identifier (e.g. float, vec2, bool, mat2, sampler2D, etc)
@@ -253,6 +287,9 @@ private:
 
   VarInfoMap m_active_uniform_info_map;
   VarInfoMap m_active_attribute_info_map;
+
+  /// @brief The values last uploaded, indexed by uniform location.  An empty entry is unknown.
+  mutable std::vector<std::vector<uint8_t>> m_uniform_shadow;
 };
 
 } // end of namespace GL
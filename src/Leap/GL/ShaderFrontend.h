@@ -8,7 +8,12 @@
 #include "Leap/GL/Internal/UniformTraits.h"
 #include "Leap/GL/ResourceBase.h"
 #include "Leap/GL/Shader.h"
+#include "Leap/GL/UniformBufferRing.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <sstream>
+#include <vector>
 
 namespace Leap {
 namespace GL {
@@ -39,6 +44,14 @@ namespace GL {
 /// the call to Shader::UploadUniform<GL_TYPE_>(...) which is made in UploadUniforms.  The C++ type will
 /// be used as the representation for that uniform value in UniformMap.  See the documentation for
 /// UniformMap for more information.
+///
+/// Uniforms which the shader declares in a uniform block (there may be one per ShaderFrontend)
+/// are not uploaded with glUniform* calls.  Instead UploadUniforms copies their values into the
+/// block's layout (as queried from the shader, e.g. std140) and streams it into
+/// UniformBufferRing::Shared(), binding the range to the block's binding point.  This needs
+/// OpenGL 3.1 or ARB_uniform_buffer_object, and the block's members must be laid out in the same
+/// way as their C++ values (so, for instance, no vec3 arrays or mat3s under std140).  Shaders
+/// without uniform blocks (e.g. plain GLSL 1.20 ones) keep using the per-uniform path.
 template <typename UniformNameType_, typename... UniformMappings_>
 class ShaderFrontend : public ResourceBase<ShaderFrontend<UniformNameType_,UniformMappings_...>> {
 private:
@@ -116,11 +129,19 @@ public:
   /// @details It will be necessary to call Initialize on this object to use it.
   ShaderFrontend ()
     : m_shader(nullptr)
-  { }
+    , m_block_binding_point(0)
+    , m_written_offset(0)
+    , m_written_generation(0)
+  {
+    m_block_offsets.fill(-1);
+  }
   /// @brief Convenience constructor that will call Initialize with the given arguments.
   template <typename... Types_>
   ShaderFrontend (const Shader *shader, const UniformIds &uniform_ids)
     : m_shader(nullptr)
+    , m_block_binding_point(0)
+    , m_written_offset(0)
+    , m_written_generation(0)
   {
     Initialize(shader, uniform_ids);
   }
@@ -142,7 +163,20 @@ public:
     }
     assert(Shader::CurrentlyBoundProgramHandle() == m_shader->ProgramHandle() && "This shader must be bound in order to upload uniforms.");
     UploadUniform<0>(uniforms);
+    if (UsesUniformBlock()) {
+      UploadBlock();
+    }
+  }
+
+  /// @brief Returns true iff the named uniform is active in the shader, either as an ordinary uniform
+  /// or as a member of a uniform block.
+  template <UniformNameType_ NAME_>
+  bool IsActive () const {
+    static const size_t INDEX = Internal::IndexIn_f<UniformNames,UniformName_t<NAME_>>::V;
+    return m_uniform_locations.template el<INDEX>() != -1 || m_block_offsets[INDEX] != -1;
   }
+  /// @brief Returns true iff some of the uniforms are members of a uniform block (see ShaderFrontend).
+  bool UsesUniformBlock () const { return !m_block_data.empty(); }
 
 private:
 
@@ -183,8 +217,15 @@ private:
     static const GLenum GL_TYPE_ = Internal::Eval_f<GlTypeMap,UniformName>::T::V;
     static const size_t ARRAY_LENGTH = Internal::Eval_f<ArrayLengthMap,UniformName>::T::V;
     static const MatrixStorageConvention MATRIX_STORAGE_CONVENTION = Internal::Eval_f<MatrixStorageConventionMap,UniformName>::T::V;
-    // Upload the uniform.
-    Internal::UniformizedInterface_UploadArray<GL_TYPE_,ARRAY_LENGTH,MATRIX_STORAGE_CONVENTION>(m_uniform_locations.template el<INDEX_>(), uniforms.template val<UniformName::V>());
+    const GLint location = m_uniform_locations.template el<INDEX_>();
+    const auto &value = uniforms.template val<UniformName::V>();
+    if (m_block_offsets[INDEX_] != -1) {
+      // Copy the uniform into the block, which UploadBlock sends.
+      memcpy(&m_block_data[m_block_offsets[INDEX_]], &value, sizeof(value));
+    } else if (m_shader->UpdateUniformShadow(location, &value, sizeof(value))) {
+      // Upload the uniform, unless the program already has this value.
+      Internal::UniformizedInterface_UploadArray<GL_TYPE_,ARRAY_LENGTH,MATRIX_STORAGE_CONVENTION>(location, value);
+    }
     // Iterate.
     UploadUniform<INDEX_+1>(uniforms);
   }
@@ -193,6 +234,106 @@ private:
     // Done with iteration.
   }
 
+  void UploadBlock () const {
+    UniformBufferRing &ring = UniformBufferRing::Shared();
+    // Successive draws often share material values, in which case the range written last can be
+    // bound again, so long as the ring hasn't been respecified since.
+    if (m_block_data == m_written_block_data && m_written_generation == ring.Generation()) {
+      ring.Rebind(m_block_binding_point, m_written_offset, m_block_data.size());
+      return;
+    }
+    m_written_offset = ring.Write(m_block_binding_point, m_block_data.data(), m_block_data.size());
+    m_written_generation = ring.Generation();
+    m_written_block_data = m_block_data;
+  }
+
+  template <size_t INDEX_>
+  typename std::enable_if<(INDEX_<UNIFORM_COUNT)>::type CheckBlockMember (const UniformIds &uniform_ids, const GLuint *uniform_indices) const {
+    typedef typename Internal::Element_f<UniformNames,INDEX_>::T UniformName;
+    static const GLenum GL_TYPE_ = Internal::Eval_f<GlTypeMap,UniformName>::T::V;
+    static const size_t ARRAY_LENGTH = Internal::Eval_f<ArrayLengthMap,UniformName>::T::V;
+    static const MatrixStorageConvention MATRIX_STORAGE_CONVENTION = Internal::Eval_f<MatrixStorageConventionMap,UniformName>::T::V;
+    typedef typename Internal::Eval_f<CppTypeMap,UniformName>::T CppType;
+    if (m_block_offsets[INDEX_] != -1) {
+      const auto &uniform_id = uniform_ids.template el<INDEX_>();
+      const GLuint program = m_shader->ProgramHandle();
+      GLint type, size, array_stride, matrix_stride, is_row_major;
+      glGetActiveUniformsiv(program, 1, &uniform_indices[INDEX_], GL_UNIFORM_TYPE, &type);
+      glGetActiveUniformsiv(program, 1, &uniform_indices[INDEX_], GL_UNIFORM_SIZE, &size);
+      glGetActiveUniformsiv(program, 1, &uniform_indices[INDEX_], GL_UNIFORM_ARRAY_STRIDE, &array_stride);
+      glGetActiveUniformsiv(program, 1, &uniform_indices[INDEX_], GL_UNIFORM_MATRIX_STRIDE, &matrix_stride);
+      glGetActiveUniformsiv(program, 1, &uniform_indices[INDEX_], GL_UNIFORM_IS_ROW_MAJOR, &is_row_major);
+      if (GL_TYPE_ != GLenum(type)) {
+        throw ShaderException("For uniform block member \"" + uniform_id + ", ShaderFrontend was looking for type " + Shader::OPENGL_3_3_UNIFORM_TYPE_MAP.at(GL_TYPE_) +
+                              " but the actual type was " + Shader::OPENGL_3_3_UNIFORM_TYPE_MAP.at(GLenum(type)) + '.');
+      }
+      if (ARRAY_LENGTH != size_t(size)) {
+        std::ostringstream out;
+        out << "For uniform block member \"" << uniform_id << ", ShaderFrontend was looking for array length " << ARRAY_LENGTH <<
+               " but the actual array length was " << size << '.';
+        throw ShaderException(out.str());
+      }
+      if (!Internal::UniformizedInterface_IsPackedInBlock<GL_TYPE_,ARRAY_LENGTH,MATRIX_STORAGE_CONVENTION>(array_stride, matrix_stride, is_row_major) ||
+          m_block_offsets[INDEX_] + sizeof(CppType) > m_block_data.size()) {
+        throw ShaderException("Uniform block member \"" + uniform_id + "\" is not laid out the same way as its C++ value, so ShaderFrontend can't copy it into the block.");
+      }
+    }
+    // Iterate.
+    CheckBlockMember<INDEX_+1>(uniform_ids, uniform_indices);
+  }
+  template <size_t INDEX_>
+  typename std::enable_if<(INDEX_>=UNIFORM_COUNT)>::type CheckBlockMember (const UniformIds &uniform_ids, const GLuint *uniform_indices) const {
+    // Done with the iteration.
+  }
+
+  // Finds the uniforms which have no location because they are in a uniform block, and sets up
+  // the block.  Throws ShaderException if they are in more than one block.
+  void InitializeBlock (const UniformIds &uniform_ids) {
+    const GLuint program = m_shader->ProgramHandle();
+    std::array<const GLchar *,UNIFORM_COUNT> names;
+    for (size_t i = 0; i < UNIFORM_COUNT; ++i) {
+      names[i] = uniform_ids.as_array()[i].c_str();
+    }
+    std::array<GLuint,UNIFORM_COUNT> uniform_indices;
+    glGetUniformIndices(program, GLsizei(UNIFORM_COUNT), names.data(), uniform_indices.data());
+
+    GLint block_index = -1;
+    for (size_t i = 0; i < UNIFORM_COUNT; ++i) {
+      if (m_uniform_locations.as_array()[i] != -1 || uniform_indices[i] == GL_INVALID_INDEX) {
+        continue;
+      }
+      GLint member_block_index = -1;
+      glGetActiveUniformsiv(program, 1, &uniform_indices[i], GL_UNIFORM_BLOCK_INDEX, &member_block_index);
+      if (member_block_index == -1) {
+        continue;
+      }
+      if (block_index != -1 && block_index != member_block_index) {
+        throw ShaderException("Uniform \"" + uniform_ids.as_array()[i] + "\" is in a different uniform block than the other uniforms of this ShaderFrontend.");
+      }
+      block_index = member_block_index;
+      glGetActiveUniformsiv(program, 1, &uniform_indices[i], GL_UNIFORM_OFFSET, &m_block_offsets[i]);
+    }
+    if (block_index == -1) {
+      return;
+    }
+
+    GLint block_size = 0;
+    GLint block_name_length = 0;
+    glGetActiveUniformBlockiv(program, GLuint(block_index), GL_UNIFORM_BLOCK_DATA_SIZE, &block_size);
+    glGetActiveUniformBlockiv(program, GLuint(block_index), GL_UNIFORM_BLOCK_NAME_LENGTH, &block_name_length);
+    std::string block_name(std::max(block_name_length, 1), ' ');
+    GLsizei length = 0;
+    glGetActiveUniformBlockName(program, GLuint(block_index), GLsizei(block_name.size()), &length, &block_name[0]);
+    block_name.resize(length);
+
+    // Members the frontend doesn't know about are left zeroed.
+    m_block_data.assign(size_t(block_size), 0);
+    m_written_block_data.clear();
+    CheckBlockMember<0>(uniform_ids, uniform_indices.data());
+    m_block_binding_point = UniformBufferRing::BindingPointOfBlock(block_name);
+    THROW_UPON_GL_ERROR(glUniformBlockBinding(program, GLuint(block_index), m_block_binding_point));
+  }
+
   friend class ResourceBase<ShaderFrontend<UniformNameType_,UniformMappings_...>>;
 
   bool IsInitialized_Implementation () const { return m_shader != nullptr; }
@@ -211,15 +352,33 @@ private:
     Leap::GL::Internal::CheckUniformTypes<UniformMappingsTyple>::Check();
     // Run-time checking of types.
     CheckType<0>(uniform_ids);
+    // Uniforms without a location may be in a uniform block.
+    m_block_offsets.fill(-1);
+    m_block_data.clear();
+    if (UniformBufferRing::IsSupported()) {
+      InitializeBlock(uniform_ids);
+    }
   }
   // Frees the allocated resources if IsInitialized(), otherwise does nothing (i.e. this method is
   // safe to call multiple times, and has no effect after the resources are freed).
   void Shutdown_Implementation () {
     m_shader = nullptr;
+    m_block_data.clear();
+    m_written_block_data.clear();
   }
 
   const Shader *m_shader;
   UniformLocations m_uniform_locations;
+
+  // The offset of each uniform in the uniform block, or -1 if it isn't in it.
+  std::array<GLint,UNIFORM_COUNT> m_block_offsets;
+  GLuint m_block_binding_point;
+  // The contents of the uniform block, which is empty if there is no block.
+  mutable std::vector<uint8_t> m_block_data;
+  // What was last written to the ring, and where.
+  mutable std::vector<uint8_t> m_written_block_data;
+  mutable size_t m_written_offset;
+  mutable uint64_t m_written_generation;
 };
 
 } // end of namespace GL
@@ -9,6 +9,7 @@ ShaderMatrices::ShaderMatrices (const Shader *shader,
                                 const std::string &model_view_matrix_id,
                                 const std::string &normal_matrix_id)
   : m_frontend(shader, Frontend::UniformIds(projection_times_model_view_matrix_id, model_view_matrix_id, normal_matrix_id))
+  , m_normal_matrix_is_used(m_frontend.IsActive<ShaderMatrix::NORMAL>())
 { }
 
 void ShaderMatrices::UploadUniforms (const EigenTypes::Matrix4x4 &model_view, const EigenTypes::Matrix4x4 &projection) {
@@ -18,8 +19,14 @@ void ShaderMatrices::UploadUniforms (const EigenTypes::Matrix4x4 &model_view, co
   uniforms.val<ShaderMatrix::MODEL_VIEW>() = model_view.cast<float>(); // same as model_view, but cast to float.
   // The inverse transpose is the correct transformation in order to keep normal EigenTypes::Vectors
   // actually perpendicular to "tangent" EigenTypes::Vectors.  If model_view is an isometry, then
-  // the inverse transpose is itself.
-  uniforms.val<ShaderMatrix::NORMAL>() = model_view.inverse().transpose().cast<float>();
+  // the inverse transpose is itself.  Normals have w = 0, so only the linear part of model_view
+  // acts on them, and only its 3x3 inverse transpose is needed.  Shaders which don't use the normal
+  // matrix get an unused location, so the value is left unset.
+  if (m_normal_matrix_is_used) {
+    EigenTypes::Matrix4x4f &normal_matrix = uniforms.val<ShaderMatrix::NORMAL>();
+    normal_matrix.setIdentity();
+    normal_matrix.topLeftCorner<3,3>() = model_view.topLeftCorner<3,3>().inverse().transpose().cast<float>();
+  }
   // Upload the uniforms
   m_frontend.UploadUniforms(uniforms);
 }
@@ -14,7 +14,7 @@ class Shader;
 /// uniform mat4 model_view_matrix
 /// uniform mat4 normal_matrix
 /// These quantities are all derived from the model view matrix and the projection matrix, which is done
-/// in a call to @c UploadUniforms.
+/// in a call to @c UploadUniforms.  The normal matrix is only computed if the shader actually uses it.
 class ShaderMatrices {
 public:
 
@@ -47,6 +47,7 @@ private:
                          ShaderMatrixUniform<ShaderMatrix::MODEL_VIEW,GL_FLOAT_MAT4,EigenTypes::Matrix4x4f,COLUMN_MAJOR>,
                          ShaderMatrixUniform<ShaderMatrix::NORMAL,GL_FLOAT_MAT4,EigenTypes::Matrix4x4f,COLUMN_MAJOR>> Frontend;
   Frontend m_frontend;
+  bool m_normal_matrix_is_used;
 };
 
 } // end of namespace GL
@@ -0,0 +1,270 @@
+#include "stdafx.h"
+#include "Leap/GL/StateCache.h"
+
+#include "Leap/GL/Error.h"
+#include <sstream>
+
+namespace Leap {
+namespace GL {
+
+namespace {
+
+// Returns the glGet* parameter giving the texture bound to target, or 0 if it isn't known here.
+GLenum TextureBindingQuery (GLenum target) {
+  switch (target) {
+    case GL_TEXTURE_1D:        return GL_TEXTURE_BINDING_1D;
+    case GL_TEXTURE_2D:        return GL_TEXTURE_BINDING_2D;
+    case GL_TEXTURE_3D:        return GL_TEXTURE_BINDING_3D;
+    case GL_TEXTURE_RECTANGLE: return GL_TEXTURE_BINDING_RECTANGLE;
+    case GL_TEXTURE_CUBE_MAP:  return GL_TEXTURE_BINDING_CUBE_MAP;
+    default:                   return 0;
+  }
+}
+
+// Returns the glGet* parameter giving the buffer bound to target, or 0 if it isn't known here.
+GLenum BufferBindingQuery (GLenum target) {
+  switch (target) {
+    case GL_ARRAY_BUFFER:         return GL_ARRAY_BUFFER_BINDING;
+    case GL_ELEMENT_ARRAY_BUFFER: return GL_ELEMENT_ARRAY_BUFFER_BINDING;
+    case GL_PIXEL_PACK_BUFFER:    return GL_PIXEL_PACK_BUFFER_BINDING;
+    case GL_PIXEL_UNPACK_BUFFER:  return GL_PIXEL_UNPACK_BUFFER_BINDING;
+    case GL_UNIFORM_BUFFER:       return GL_UNIFORM_BUFFER_BINDING;
+    default:                      return 0;
+  }
+}
+
+void ThrowUponMismatch (const char *what, GLuint expected, GLint actual) {
+  if (GLint(expected) != actual) {
+    std::ostringstream out;
+    out << "StateCache expected " << what << ' ' << expected << ", but GL has " << actual << " (was it changed without going through the cache?)";
+    throw Leap::GL::Exception(out.str());
+  }
+}
+
+} // end of anonymous namespace
+
+StateCache::DeferredUnbindScope::DeferredUnbindScope () {
+  StateCache::Current().beginDeferringUnbinds();
+}
+
+StateCache::DeferredUnbindScope::~DeferredUnbindScope () {
+  StateCache::Current().endDeferringUnbinds();
+}
+
+StateCache::StateCache ()
+  : m_defer_depth(0)
+  , m_validation_enabled(false)
+{ }
+
+StateCache &StateCache::Current () {
+  static StateCache cache;
+  return cache;
+}
+
+void StateCache::UseProgram (GLuint program) {
+  if (update(m_program, program, true)) {
+    THROW_UPON_GL_ERROR(glUseProgram(program));
+  }
+  if (m_validation_enabled) {
+    validateProgram();
+  }
+}
+
+void StateCache::BindTexture (GLuint unit, GLenum target, GLuint texture) {
+  // The unit is left active even if the binding is already current, since callers may go on to
+  // call e.g. glTexSubImage2D, which acts on the active unit.
+  activeTexture(unit);
+  if (update(textureBindings(unit)[target], texture, true)) {
+    THROW_UPON_GL_ERROR(glBindTexture(target, texture));
+  }
+  if (m_validation_enabled) {
+    validateTexture(unit, target);
+  }
+}
+
+void StateCache::BindBuffer (GLenum target, GLuint buffer) {
+  if (target == GL_ELEMENT_ARRAY_BUFFER && m_vertex_array.unbind_pending) {
+    // Don't change the index buffer of the vertex array object left bound by a deferred unbind.
+    bindVertexArray(0, false);
+  }
+  if (update(m_buffers[target], buffer, false)) {
+    THROW_UPON_GL_ERROR(glBindBuffer(target, buffer));
+  }
+  if (m_validation_enabled) {
+    validateBuffer(target);
+  }
+}
+
+void StateCache::BindBufferRange (GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+  THROW_UPON_GL_ERROR(glBindBufferRange(target, index, buffer, offset, size));
+  m_stats.issued++;
+  Binding &binding = m_buffers[target];
+  binding.known = true;
+  binding.name = buffer;
+  if (m_validation_enabled) {
+    validateBuffer(target);
+  }
+}
+
+void StateCache::BindVertexArray (GLuint vertex_array) {
+  bindVertexArray(vertex_array, true);
+}
+
+GLuint StateCache::CurrentProgram () {
+  if (!m_program.known) {
+    GLint program = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    m_program.known = true;
+    m_program.unbind_pending = false;
+    m_program.name = GLuint(program);
+  }
+  return m_program.name;
+}
+
+void StateCache::ForgetProgram (GLuint program) {
+  if (m_program.name == program) {
+    m_program = Binding();
+  }
+}
+
+void StateCache::ForgetTexture (GLuint texture) {
+  for (TargetBindings &bindings : m_textures) {
+    for (auto &binding : bindings) {
+      if (binding.second.known && binding.second.name == texture) {
+        binding.second.name = 0;
+        binding.second.unbind_pending = false;
+      }
+    }
+  }
+}
+
+void StateCache::ForgetBuffer (GLuint buffer) {
+  for (auto &binding : m_buffers) {
+    if (binding.second.known && binding.second.name == buffer) {
+      binding.second.name = 0;
+    }
+  }
+}
+
+void StateCache::ForgetVertexArray (GLuint vertex_array) {
+  if (m_vertex_array.known && m_vertex_array.name == vertex_array) {
+    m_vertex_array.name = 0;
+    m_vertex_array.unbind_pending = false;
+    m_buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+  }
+}
+
+void StateCache::Invalidate () {
+  m_program = Binding();
+  m_active_texture = Binding();
+  m_textures.clear();
+  m_buffers.clear();
+  m_vertex_array = Binding();
+}
+
+void StateCache::beginDeferringUnbinds () {
+  m_defer_depth++;
+}
+
+void StateCache::endDeferringUnbinds () {
+  if (--m_defer_depth > 0) {
+    return;
+  }
+  // Carry out the unbinds which are still pending.
+  if (m_program.unbind_pending) {
+    UseProgram(0);
+  }
+  if (m_vertex_array.unbind_pending) {
+    BindVertexArray(0);
+  }
+  for (GLuint unit = 0; unit < m_textures.size(); ++unit) {
+    for (auto &binding : m_textures[unit]) {
+      if (binding.second.unbind_pending) {
+        BindTexture(unit, binding.first, 0);
+      }
+    }
+  }
+}
+
+bool StateCache::update (Binding &binding, GLuint name, bool deferrable) {
+  if (name == 0 && deferrable && m_defer_depth > 0 && binding.known) {
+    binding.unbind_pending = binding.name != 0;
+    m_stats.skipped++;
+    return false;
+  }
+  binding.unbind_pending = false;
+  if (binding.known && binding.name == name) {
+    m_stats.skipped++;
+    return false;
+  }
+  binding.known = true;
+  binding.name = name;
+  m_stats.issued++;
+  return true;
+}
+
+void StateCache::activeTexture (GLuint unit) {
+  if (update(m_active_texture, unit, false)) {
+    THROW_UPON_GL_ERROR(glActiveTexture(GL_TEXTURE0 + unit));
+  }
+}
+
+void StateCache::bindVertexArray (GLuint vertex_array, bool deferrable) {
+  if (update(m_vertex_array, vertex_array, deferrable)) {
+    THROW_UPON_GL_ERROR(glBindVertexArray(vertex_array));
+    // The index buffer binding is part of the vertex array object's state.
+    m_buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+  }
+  if (m_validation_enabled) {
+    validateVertexArray();
+  }
+}
+
+StateCache::TargetBindings &StateCache::textureBindings (GLuint unit) {
+  if (unit >= m_textures.size()) {
+    m_textures.resize(unit + 1);
+  }
+  return m_textures[unit];
+}
+
+void StateCache::validateProgram () const {
+  if (m_program.known) {
+    GLint program = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    ThrowUponMismatch("current program", m_program.name, program);
+  }
+}
+
+void StateCache::validateTexture (GLuint unit, GLenum target) const {
+  GLint active_texture = 0;
+  glGetIntegerv(GL_ACTIVE_TEXTURE, &active_texture);
+  ThrowUponMismatch("active texture unit", GL_TEXTURE0 + unit, active_texture);
+  const GLenum query = TextureBindingQuery(target);
+  const auto it = m_textures[unit].find(target);
+  if (query != 0 && it != m_textures[unit].end() && it->second.known) {
+    GLint texture = 0;
+    glGetIntegerv(query, &texture);
+    ThrowUponMismatch("bound texture", it->second.name, texture);
+  }
+}
+
+void StateCache::validateBuffer (GLenum target) const {
+  const GLenum query = BufferBindingQuery(target);
+  const auto it = m_buffers.find(target);
+  if (query != 0 && it != m_buffers.end() && it->second.known) {
+    GLint buffer = 0;
+    glGetIntegerv(query, &buffer);
+    ThrowUponMismatch("bound buffer", it->second.name, buffer);
+  }
+}
+
+void StateCache::validateVertexArray () const {
+  if (m_vertex_array.known) {
+    GLint vertex_array = 0;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertex_array);
+    ThrowUponMismatch("bound vertex array", m_vertex_array.name, vertex_array);
+  }
+}
+
+} // end of namespace GL
+} // end of namespace Leap
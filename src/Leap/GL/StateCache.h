@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Leap/GL/GLHeaders.h"
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace Leap {
+namespace GL {
+
+/// @brief Shadows the GL context's program, texture, buffer and vertex array bindings, so that redundant
+/// glUseProgram, glActiveTexture, glBindTexture, glBindBuffer and glBindVertexArray calls aren't made.
+/// @details Shader, Texture2, BufferObject and Mesh bind and unbind themselves through the cache
+/// returned by Current().  A binding that the cache hasn't seen set (since it was constructed or
+/// last invalidated) is unknown, so the first request for it always reaches GL.  Code which
+/// changes these bindings without going through the cache (e.g. a third-party renderer) must be
+/// followed by a call to Invalidate.
+///
+/// Unbinding (binding program, texture, buffer or vertex array 0) normally reaches GL at once.
+/// Within a DeferredUnbindScope, program, texture and vertex array unbinds are instead postponed
+/// until the end of the scope, so that binding the same object again right afterward costs
+/// nothing.  Buffer unbinds are never deferred, since e.g. a pixel buffer left bound changes the
+/// meaning of later texture uploads.  Since the index buffer binding belongs to the bound vertex
+/// array object, a pending vertex array unbind is carried out before an index buffer is bound.
+///
+/// With validation enabled (see SetValidationEnabled), every request cross-checks the cached
+/// state against glGet* and throws Leap::GL::Exception upon a mismatch, which points out GL
+/// calls that bypass the cache.  This is slow, and meant for debugging.
+class StateCache {
+public:
+
+  /// @brief Counts of the requests which reached GL, and of those which were skipped as redundant.
+  struct CallStats {
+    CallStats () : issued(0), skipped(0) { }
+    uint64_t issued;
+    uint64_t skipped;
+  };
+
+  /// @brief Postpones program, texture and vertex array unbinds for its lifetime (see StateCache).
+  class DeferredUnbindScope {
+  public:
+    DeferredUnbindScope ();
+    ~DeferredUnbindScope ();
+  private:
+    DeferredUnbindScope (const DeferredUnbindScope &);
+    DeferredUnbindScope &operator = (const DeferredUnbindScope &);
+  };
+
+  StateCache ();
+
+  /// @brief Returns the cache for the current GL context (there is only one context in this application).
+  static StateCache &Current ();
+
+  /// @brief Makes the given program current via glUseProgram, unless it already is.
+  void UseProgram (GLuint program);
+  /// @brief Binds the texture to the target of the given texture unit (counting from 0, not
+  /// from GL_TEXTURE0), calling glActiveTexture and glBindTexture only as needed.
+  void BindTexture (GLuint unit, GLenum target, GLuint texture);
+  /// @brief Binds the buffer to the given target via glBindBuffer, unless it already is.
+  void BindBuffer (GLenum target, GLuint buffer);
+  /// @brief Calls glBindBufferRange, which also binds the buffer to the generic target.
+  void BindBufferRange (GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+  /// @brief Binds the vertex array object via glBindVertexArray, unless it already is.
+  /// @details This makes the index buffer binding unknown, since it is part of the vertex array object.
+  void BindVertexArray (GLuint vertex_array);
+
+  /// @brief Returns the current program, querying GL only if it's unknown.
+  GLuint CurrentProgram ();
+
+  /// @brief Must be called when a program is deleted, since GL may reuse its name.
+  void ForgetProgram (GLuint program);
+  /// @brief Must be called when a texture is deleted; GL unbinds it from every unit.
+  void ForgetTexture (GLuint texture);
+  /// @brief Must be called when a buffer is deleted; GL unbinds it from every target.
+  void ForgetBuffer (GLuint buffer);
+  /// @brief Must be called when a vertex array object is deleted; GL unbinds it if it is bound.
+  void ForgetVertexArray (GLuint vertex_array);
+  /// @brief Marks all of the state unknown, e.g. after code that doesn't use the cache.
+  void Invalidate ();
+
+  /// @brief Enables or disables the cross-checking of the cached state against glGet*.
+  void SetValidationEnabled (bool enabled) { m_validation_enabled = enabled; }
+  bool IsValidationEnabled () const { return m_validation_enabled; }
+
+  /// @brief Returns the running counts of requests, which may be reset by assigning CallStats().
+  CallStats &Stats () { return m_stats; }
+
+private:
+
+  // A cached binding.  If !known, name is meaningless.  unbind_pending means that 0 was requested
+  // within a DeferredUnbindScope, but name is still what GL has bound.
+  struct Binding {
+    Binding () : known(false), unbind_pending(false), name(0) { }
+    bool known;
+    bool unbind_pending;
+    GLuint name;
+  };
+  typedef std::map<GLenum,Binding> TargetBindings;
+
+  void beginDeferringUnbinds ();
+  void endDeferringUnbinds ();
+  // Returns true iff GL has to be called to make binding hold name.  Counts the request either way.
+  bool update (Binding &binding, GLuint name, bool deferrable);
+  void activeTexture (GLuint unit);
+  void bindVertexArray (GLuint vertex_array, bool deferrable);
+  TargetBindings &textureBindings (GLuint unit);
+
+  void validateProgram () const;
+  void validateTexture (GLuint unit, GLenum target) const;
+  void validateBuffer (GLenum target) const;
+  void validateVertexArray () const;
+
+  Binding m_program;
+  Binding m_active_texture;
+  std::vector<TargetBindings> m_textures;
+  TargetBindings m_buffers;
+  Binding m_vertex_array;
+  int m_defer_depth;
+  bool m_validation_enabled;
+  CallStats m_stats;
+};
+
+} // end of namespace GL
+} // end of namespace Leap
@@ -3,6 +3,7 @@
 
 #include <cassert>
 #include "Leap/GL/Error.h"
+#include "Leap/GL/StateCache.h"
 #include <sstream>
 
 namespace Leap {
@@ -220,7 +221,7 @@ void Texture2::Initialize_Implementation (const Texture2Params &params, const Te
   ClearGLError();
   glGenTextures(1, &m_texture_name);
   ThrowUponGLError("in glGenTextures");
-  glBindTexture(m_params.Target(), m_texture_name);
+  Bind();
 
   Texture2PixelData::GLPixelStoreiParameterMap overridden_pixel_store_i_parameter_map;  
   try {
@@ -253,7 +254,7 @@ void Texture2::Initialize_Implementation (const Texture2Params &params, const Te
     // Restore the PixelStorei parameter values that were overridden above.
     RestorePixelStoreiParameters(overridden_pixel_store_i_parameter_map);
     // Unbind the texture to minimize the possibility that other GL calls may modify this texture.
-    glBindTexture(m_params.Target(), 0);
+    Unbind();
     throw;
   }
 
@@ -267,13 +268,14 @@ void Texture2::Initialize_Implementation (const Texture2Params &params, const Te
   m_params.SetInternalFormat(actual_internal_format);
 
   // Unbind the texture to minimize the possibility that other GL calls may modify this texture.
-  glBindTexture(m_params.Target(), 0);
+  Unbind();
 }
 
 void Texture2::Shutdown_Implementation () {
   // TODO: should we check here if the texture is still bound?
   m_params.Clear();
   glDeleteTextures(1, &m_texture_name);
+  StateCache::Current().ForgetTexture(m_texture_name);
   m_texture_name = 0; // This is what defines !IsInitialized().
 }
 
@@ -2,6 +2,7 @@
 
 #include "Leap/GL/GLHeaders.h" // convenience header for cross-platform GL includes
 #include "Leap/GL/ResourceBase.h"
+#include "Leap/GL/StateCache.h"
 #include "Leap/GL/Texture2Params.h"
 #include "Leap/GL/Texture2PixelData.h"
 #include "Leap/GL/Texture2Exception.h"
@@ -54,17 +55,16 @@ public:
       throw Texture2Exception("Can't Bind a Texture2 that !IsInitialized().");
     }
     m_TextureUnit = textureUnit;
-    glActiveTexture(GL_TEXTURE0 + m_TextureUnit);
-    glBindTexture(m_params.Target(), m_texture_name);
+    StateCache::Current().BindTexture(m_TextureUnit, m_params.Target(), m_texture_name);
   }
   /// @brief This method should be called when no texture should be used (for the active texture unit).
-  /// @details This will throw Texture2Exception if this texture !IsInitialized().
+  /// @details This will throw Texture2Exception if this texture !IsInitialized().  Within a
+  /// StateCache::DeferredUnbindScope, the texture is only unbound at the end of the scope.
   void Unbind () const {
     if (!IsInitialized()) {
       throw Texture2Exception("Can't Unbind a Texture2 that !IsInitialized().");
     }
-    glActiveTexture(GL_TEXTURE0 + m_TextureUnit);
-    glBindTexture(m_params.Target(), 0);
+    StateCache::Current().BindTexture(m_TextureUnit, m_params.Target(), 0);
   }
 
   /// @brief Returns the texture name (GLuint assigned by OpenGL upon generation).
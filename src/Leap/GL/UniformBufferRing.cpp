@@ -0,0 +1,101 @@
+#include "stdafx.h"
+#include "Leap/GL/UniformBufferRing.h"
+
+#include "Leap/GL/Error.h"
+#include "Leap/GL/StateCache.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+namespace Leap {
+namespace GL {
+
+UniformBufferRing::UniformBufferRing (size_t capacity)
+  : m_capacity(capacity)
+  , m_offset(0)
+  , m_alignment(1)
+  , m_generation(0)
+  , m_map_buffer_range(false)
+{ }
+
+bool UniformBufferRing::IsSupported () {
+  return GLEW_VERSION_3_1 || GLEW_ARB_uniform_buffer_object;
+}
+
+UniformBufferRing &UniformBufferRing::Shared () {
+  static UniformBufferRing ring;
+  return ring;
+}
+
+GLuint UniformBufferRing::BindingPointOfBlock (const std::string &block_name) {
+  static std::map<std::string,GLuint> binding_points;
+  auto it = binding_points.find(block_name);
+  if (it == binding_points.end()) {
+    it = binding_points.insert(std::make_pair(block_name, static_cast<GLuint>(binding_points.size()))).first;
+  }
+  return it->second;
+}
+
+void UniformBufferRing::BeginFrame () {
+  if (m_buffer.IsInitialized() && m_offset > 0) {
+    orphan();
+  }
+}
+
+size_t UniformBufferRing::Write (GLuint binding_point, const void *data, size_t size) {
+  if (!m_buffer.IsInitialized()) {
+    GLint alignment = 1;
+    THROW_UPON_GL_ERROR(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+    m_alignment = static_cast<size_t>(std::max(alignment, 1));
+    m_map_buffer_range = GLEW_VERSION_3_0 || GLEW_ARB_map_buffer_range;
+    m_buffer.Initialize(GL_UNIFORM_BUFFER);
+    orphan();
+  }
+  if (size > m_capacity) {
+    throw Exception("UniformBufferRing::Write was given more data than the ring's capacity.");
+  }
+
+  size_t offset = (m_offset + m_alignment - 1) / m_alignment * m_alignment;
+  if (offset + size > m_capacity) {
+    orphan();
+    offset = 0;
+  }
+  // The range hasn't been written since the storage was last respecified, so no draw can be
+  // reading it, and the driver needn't synchronize with them or preserve its old contents.
+  void *mapped = nullptr;
+  if (m_map_buffer_range) {
+    mapped = m_buffer.MapBufferRange(static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+  }
+  if (mapped) {
+    std::memcpy(mapped, data, size);
+    if (!m_buffer.UnmapBuffer()) {
+      // The buffer's contents were lost (e.g. on a display mode change); write this range again.
+      m_buffer.Bind();
+      m_buffer.BufferSubData(static_cast<GLintptr>(offset), data, static_cast<GLsizeiptr>(size));
+      m_buffer.Unbind();
+    }
+  } else {
+    m_buffer.Bind();
+    m_buffer.BufferSubData(static_cast<GLintptr>(offset), data, static_cast<GLsizeiptr>(size));
+    m_buffer.Unbind();
+  }
+  m_offset = offset + size;
+
+  Rebind(binding_point, offset, size);
+  return offset;
+}
+
+void UniformBufferRing::Rebind (GLuint binding_point, size_t offset, size_t size) {
+  StateCache::Current().BindBufferRange(GL_UNIFORM_BUFFER, binding_point, m_buffer.Address(), static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+}
+
+void UniformBufferRing::orphan () {
+  m_buffer.Bind();
+  m_buffer.BufferData(nullptr, static_cast<GLsizeiptr>(m_capacity), GL_STREAM_DRAW);
+  m_buffer.Unbind();
+  m_offset = 0;
+  m_generation++;
+}
+
+} // end of namespace GL
+} // end of namespace Leap
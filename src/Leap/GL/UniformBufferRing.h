@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Leap/GL/BufferObject.h"
+#include "Leap/GL/GLHeaders.h"
+#include <cstdint>
+#include <string>
+
+namespace Leap {
+namespace GL {
+
+/// @brief A uniform buffer which the contents of uniform blocks are streamed into, one range per draw.
+/// @details ShaderFrontend uses this to fill the uniform blocks of shaders that have them (see
+/// ShaderFrontend): each UploadUniforms call appends the block's data at the next suitably aligned
+/// offset and binds that range to the block's binding point via glBindBufferRange.  This replaces
+/// a glUniform* call per uniform with one write and one glBindBufferRange per block.  The write
+/// maps just that range, unsynchronized, where glMapBufferRange is available, so the driver
+/// neither copies the data aside nor waits for earlier draws; otherwise it's a glBufferSubData.
+///
+/// Ranges are never overwritten while a draw might still read them: BeginFrame, and running out
+/// of room, respecify (orphan) the buffer storage, so the driver hands out fresh memory instead
+/// of waiting for earlier draws.  Calling BeginFrame once per frame keeps the buffer from having
+/// to grow past the capacity given to the constructor.
+///
+/// Requires OpenGL 3.1 or ARB_uniform_buffer_object (see IsSupported).  The GL resources are
+/// acquired upon first use, so this may be constructed before there is a GL context.
+class UniformBufferRing {
+public:
+
+  /// @brief Construct a ring holding capacity bytes (once it acquires its GL resources).
+  UniformBufferRing (size_t capacity = DEFAULT_CAPACITY);
+
+  /// @brief Returns true iff the current GL context supports uniform buffer objects.
+  static bool IsSupported ();
+  /// @brief Returns the ring used by all ShaderFrontend objects.
+  static UniformBufferRing &Shared ();
+  /// @brief Returns the binding point which uniform blocks with the given name are bound to.
+  /// @details Each distinct name gets its own binding point, so the different blocks used by one
+  /// shader program never share one.
+  static GLuint BindingPointOfBlock (const std::string &block_name);
+
+  /// @brief Starts a new frame, discarding (from this object's point of view) everything written.
+  void BeginFrame ();
+  /// @brief Appends size bytes of block data, and binds them to the given binding point.
+  /// @details Returns the offset at which the data was written, which may be passed to Rebind
+  /// for as long as Generation() is unchanged.
+  size_t Write (GLuint binding_point, const void *data, size_t size);
+  /// @brief Binds a range previously written (during the current generation) to the given binding point.
+  void Rebind (GLuint binding_point, size_t offset, size_t size);
+  /// @brief Incremented every time the buffer storage is respecified, which invalidates the offsets
+  /// returned by Write.
+  uint64_t Generation () const { return m_generation; }
+
+  static const size_t DEFAULT_CAPACITY = 1 << 20;
+
+private:
+
+  void orphan ();
+
+  BufferObject m_buffer;
+  size_t m_capacity;
+  size_t m_offset;
+  size_t m_alignment;
+  uint64_t m_generation;
+  // Whether Write maps the range it writes (OpenGL 3.0 or ARB_map_buffer_range) instead of using glBufferSubData.
+  bool m_map_buffer_range;
+};
+
+} // end of namespace GL
+} // end of namespace Leap
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// A bounded, lock-free ring buffer with a single producer and a single consumer.
+// When the buffer is full, Push discards the oldest element instead of blocking,
+// so the producer never waits on the consumer (and vice versa), beyond a short
+// bounded retry while the consumer finishes moving an element out of a slot.
+//
+// Each slot carries a sequence number (in the style of Vyukov's bounded queue)
+// which tells whether the slot is ready to be written or ready to be read.  The
+// read index is advanced with a compare-and-swap, which lets the producer claim
+// and discard the oldest element without racing with the consumer -- exactly one
+// side ever moves a given element out of its slot.  The capacity is rounded up
+// to a power of two.
+template <typename T>
+class DropOldestRingBuffer {
+public:
+
+  explicit DropOldestRingBuffer(size_t capacity)
+    :
+    m_slots(RoundUpToPowerOfTwo(capacity)),
+    m_mask(m_slots.size() - 1),
+    m_writeIndex(0),
+    m_readIndex(0),
+    m_dropCount(0),
+    m_peakOccupancy(0)
+  {
+    for (size_t i = 0; i < m_slots.size(); i++) {
+      m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  size_t Capacity() const { return m_slots.size(); }
+
+  // Producer side only.  Returns false if an element had to be dropped: normally
+  // the oldest one, to make room for this one.  If the consumer is still moving
+  // an element out of the slot this one needs and does not finish within a
+  // bounded number of retries, this element is dropped instead of waiting.
+  bool Push(const T& value) {
+    bool dropped = false;
+    const uint64_t write = m_writeIndex.load(std::memory_order_relaxed);
+    Slot& slot = m_slots[write & m_mask];
+    int busyRetries = 0;
+    while (slot.sequence.load(std::memory_order_acquire) != write) {
+      // The slot is still occupied.  If the buffer is genuinely full, discard the
+      // oldest element; otherwise the consumer is in the middle of reading it.
+      const uint64_t read = m_readIndex.load(std::memory_order_acquire);
+      if (write - read >= m_slots.size()) {
+        T discarded;
+        if (Pop(discarded)) {
+          m_dropCount.fetch_add(1, std::memory_order_relaxed);
+          dropped = true;
+        }
+      } else if (++busyRetries > MAX_BUSY_RETRIES) {
+        m_dropCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    slot.value = value;
+    slot.sequence.store(write + 1, std::memory_order_release);
+    m_writeIndex.store(write + 1, std::memory_order_release);
+
+    const uint64_t occupancy = write + 1 - m_readIndex.load(std::memory_order_relaxed);
+    uint64_t peak = m_peakOccupancy.load(std::memory_order_relaxed);
+    while (occupancy > peak && !m_peakOccupancy.compare_exchange_weak(peak, occupancy, std::memory_order_relaxed)) { }
+    return !dropped;
+  }
+
+  // Consumer side (and the producer, when dropping).  Returns false if empty.
+  bool Pop(T& value) {
+    uint64_t read = m_readIndex.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot = m_slots[read & m_mask];
+      const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+      if (sequence != read + 1) {
+        if (sequence <= read) {
+          return false; // empty
+        }
+        read = m_readIndex.load(std::memory_order_relaxed); // fell behind another reader
+      } else if (m_readIndex.compare_exchange_weak(read, read + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+        value = std::move(slot.value);
+        slot.value = T();
+        slot.sequence.store(read + m_slots.size(), std::memory_order_release);
+        return true;
+      }
+    }
+  }
+
+  // Approximate number of elements currently held.  Exact when neither side is active.
+  size_t Occupancy() const {
+    const uint64_t read = m_readIndex.load(std::memory_order_acquire);
+    const uint64_t write = m_writeIndex.load(std::memory_order_acquire);
+    return write > read ? static_cast<size_t>(write - read) : 0;
+  }
+
+  uint64_t DropCount() const { return m_dropCount.load(std::memory_order_relaxed); }
+  uint64_t PeakOccupancy() const { return m_peakOccupancy.load(std::memory_order_relaxed); }
+
+private:
+
+  static size_t RoundUpToPowerOfTwo(size_t capacity) {
+    if (capacity == 0) {
+      throw std::invalid_argument("DropOldestRingBuffer capacity must be positive");
+    }
+    size_t result = 1;
+    while (result < capacity) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  // How many times Push yields while the consumer finishes reading a slot.
+  static const int MAX_BUSY_RETRIES = 16;
+
+  struct Slot {
+    Slot() : sequence(0) { }
+    Slot(const Slot&) : sequence(0) { }
+    std::atomic<uint64_t> sequence;
+    T value;
+  };
+
+  std::vector<Slot> m_slots;
+  const uint64_t m_mask;
+  std::atomic<uint64_t> m_writeIndex;
+  std::atomic<uint64_t> m_readIndex;
+  std::atomic<uint64_t> m_dropCount;
+  std::atomic<uint64_t> m_peakOccupancy;
+};
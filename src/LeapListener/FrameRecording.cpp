@@ -0,0 +1,385 @@
+#include "stdafx.h"
+#include "FrameRecording.h"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if !_WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+size_t paddedSize(size_t numBytes) {
+  return (numBytes + 3) & ~static_cast<size_t>(3);
+}
+
+template <typename T>
+void append(std::vector<unsigned char>& buffer, const T& value) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+void appendPadded(std::vector<unsigned char>& buffer, const void* data, size_t numBytes) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+  buffer.insert(buffer.end(), bytes, bytes + numBytes);
+  buffer.resize(buffer.size() + paddedSize(numBytes) - numBytes, 0);
+}
+
+// The number of bytes left before end.  Reads compare against this rather than forming
+// cursor + n, which would be undefined behaviour if it pointed past the mapping.
+size_t remaining(const unsigned char* cursor, const unsigned char* end) {
+  return static_cast<size_t>(end - cursor);
+}
+
+template <typename T>
+T read(const unsigned char*& cursor, const unsigned char* end) {
+  if (sizeof(T) > remaining(cursor, end)) {
+    throw std::runtime_error("Truncated frame recording");
+  }
+  T value;
+  std::memcpy(&value, cursor, sizeof(T));
+  cursor += sizeof(T);
+  return value;
+}
+
+const unsigned char* skipPadded(const unsigned char*& cursor, const unsigned char* end, size_t numBytes) {
+  const unsigned char* start = cursor;
+  // paddedSize would wrap around for sizes within 3 bytes of the maximum
+  if (numBytes > remaining(cursor, end) || paddedSize(numBytes) > remaining(cursor, end)) {
+    throw std::runtime_error("Truncated frame recording");
+  }
+  cursor += paddedSize(numBytes);
+  return start;
+}
+
+// Returns rows*columns*elementBytes, the size of an image or distortion map read from a
+// recording, rejecting negative dimensions and sizes that don't fit in a size_t.
+size_t arrayBytes(int32_t rows, int32_t columns, size_t elementBytes) {
+  if (rows < 0 || columns < 0) {
+    throw std::runtime_error("Corrupt frame recording: negative image dimensions");
+  }
+  const size_t max = std::numeric_limits<size_t>::max();
+  size_t bytes = static_cast<size_t>(rows);
+  if (columns != 0 && bytes > max / static_cast<size_t>(columns)) {
+    throw std::runtime_error("Corrupt frame recording: image too large");
+  }
+  bytes *= static_cast<size_t>(columns);
+  if (elementBytes != 0 && bytes > max / elementBytes) {
+    throw std::runtime_error("Corrupt frame recording: image too large");
+  }
+  return bytes * elementBytes;
+}
+
+void storeVector(const Leap::Vector& vector, float* out) {
+  out[0] = vector.x;
+  out[1] = vector.y;
+  out[2] = vector.z;
+}
+
+}
+
+Leap::Frame FrameRecording::Frame::Deserialize() const {
+  Leap::Frame frame;
+  frame.deserialize(std::string(reinterpret_cast<const char*>(serialized), serializedBytes));
+  return frame;
+}
+
+FrameRecorder::FrameRecorder(const std::string& path, bool recordImages) :
+  m_stream(path, std::ios::binary | std::ios::trunc),
+  m_recordImages(recordImages),
+  m_frameCount(0),
+  m_writing(false),
+  m_stopping(false)
+{
+  if (!m_stream) {
+    throw std::runtime_error("Unable to open frame recording for writing: " + path);
+  }
+  FrameRecording::FileHeader header;
+  std::memcpy(header.magic, FrameRecording::MAGIC, sizeof(header.magic));
+  header.version = FrameRecording::VERSION;
+  header.flags = m_recordImages ? FrameRecording::HAS_IMAGES : 0;
+  header.reserved = 0;
+  m_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  m_writer = std::thread(&FrameRecorder::writerMain, this);
+}
+
+FrameRecorder::~FrameRecorder() {
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_pendingChanged.notify_all();
+  m_writer.join();
+  m_stream.flush();
+}
+
+void FrameRecorder::WriteFrame(const Leap::Frame& frame) {
+  rethrowWriterError();
+
+  const std::string serialized = frame.serialize();
+  const Leap::ImageList images = m_recordImages ? frame.images() : Leap::ImageList();
+
+  std::vector<unsigned char> buffer;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_spareBuffers.empty()) {
+      buffer.swap(m_spareBuffers.back());
+      m_spareBuffers.pop_back();
+    }
+  }
+  buffer.clear();
+
+  // Leave room for the record size, which is filled in once the record is encoded
+  append(buffer, static_cast<uint32_t>(0));
+
+  FrameRecording::RecordHeader record;
+  record.timestamp = frame.timestamp();
+  record.frameId = frame.id();
+  record.serializedBytes = static_cast<uint32_t>(serialized.size());
+  record.imageCount = static_cast<uint32_t>(images.count());
+  append(buffer, record);
+  appendPadded(buffer, serialized.data(), serialized.size());
+
+  const Leap::TrackedQuad quad = frame.trackedQuad();
+  FrameRecording::TrackedQuad trackedQuad;
+  std::memset(&trackedQuad, 0, sizeof(trackedQuad));
+  trackedQuad.valid = quad.isValid() ? 1 : 0;
+  if (quad.isValid()) {
+    const Leap::Matrix orientation = quad.orientation();
+    trackedQuad.visible = quad.visible() ? 1 : 0;
+    trackedQuad.width = quad.width();
+    trackedQuad.height = quad.height();
+    storeVector(quad.position(), trackedQuad.position);
+    storeVector(orientation.xBasis, trackedQuad.orientation + 0);
+    storeVector(orientation.yBasis, trackedQuad.orientation + 3);
+    storeVector(orientation.zBasis, trackedQuad.orientation + 6);
+  }
+  append(buffer, trackedQuad);
+
+  for (int i = 0; i < images.count(); i++) {
+    const Leap::Image image = images[i];
+    FrameRecording::ImageHeader imageHeader;
+    imageHeader.id = image.id();
+    imageHeader.width = image.width();
+    imageHeader.height = image.height();
+    imageHeader.bytesPerPixel = image.bytesPerPixel();
+    imageHeader.distortionWidth = image.distortionWidth();
+    imageHeader.distortionHeight = image.distortionHeight();
+    append(buffer, imageHeader);
+    appendPadded(buffer, image.data(), static_cast<size_t>(image.width() * image.height() * image.bytesPerPixel()));
+    appendPadded(buffer, image.distortion(), static_cast<size_t>(image.distortionWidth() * image.distortionHeight()) * sizeof(float));
+  }
+
+  const uint32_t recordBytes = static_cast<uint32_t>(buffer.size() - sizeof(uint32_t));
+  std::memcpy(buffer.data(), &recordBytes, sizeof(recordBytes));
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_pending.push_back(std::move(buffer));
+  }
+  m_pendingChanged.notify_all();
+  m_frameCount++;
+}
+
+void FrameRecorder::Flush() {
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_pendingChanged.wait(lock, [this] { return (m_pending.empty() && !m_writing) || m_writerError; });
+  }
+  rethrowWriterError();
+}
+
+void FrameRecorder::writerMain() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_pendingChanged.wait(lock, [this] { return !m_pending.empty() || m_stopping; });
+    if (m_pending.empty() || m_writerError) {
+      // Stopping with nothing left to write, or nothing more can be written
+      if (m_stopping) {
+        break;
+      }
+      m_pending.clear();
+      continue;
+    }
+    std::vector<unsigned char> buffer(std::move(m_pending.front()));
+    m_pending.pop_front();
+    m_writing = true;
+    lock.unlock();
+
+    m_stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    const bool failed = !m_stream;
+
+    lock.lock();
+    m_writing = false;
+    if (failed) {
+      m_writerError = std::make_exception_ptr(std::runtime_error("Unable to write to frame recording"));
+    }
+    m_spareBuffers.push_back(std::move(buffer));
+    m_pendingChanged.notify_all();
+  }
+}
+
+void FrameRecorder::rethrowWriterError() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_writerError) {
+    std::exception_ptr error = m_writerError;
+    m_writerError = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+FrameRecordingReader::FrameRecordingReader(const std::string& path) :
+  m_data(nullptr),
+  m_size(0),
+#if _WIN32
+  m_fileHandle(INVALID_HANDLE_VALUE),
+  m_mappingHandle(nullptr),
+#else
+  m_fileDescriptor(-1),
+#endif
+  m_flags(0)
+{
+  map(path);
+  try {
+    const unsigned char* cursor = m_data;
+    const unsigned char* end = m_data + m_size;
+    const FrameRecording::FileHeader header = read<FrameRecording::FileHeader>(cursor, end);
+    if (std::memcmp(header.magic, FrameRecording::MAGIC, sizeof(header.magic)) != 0) {
+      throw std::runtime_error("Not a frame recording: " + path);
+    }
+    if (header.version != FrameRecording::VERSION) {
+      throw std::runtime_error("Unsupported frame recording version: " + path);
+    }
+    m_flags = header.flags;
+
+    // A recording cut short by a crash may end with a partial record; ignore it.
+    while (sizeof(uint32_t) <= remaining(cursor, end)) {
+      const uint32_t recordBytes = read<uint32_t>(cursor, end);
+      if (recordBytes > remaining(cursor, end)) {
+        break;
+      }
+      m_recordOffsets.push_back(static_cast<size_t>(cursor - m_data));
+      cursor += recordBytes;
+    }
+  } catch (...) {
+    unmap();
+    throw;
+  }
+}
+
+FrameRecordingReader::~FrameRecordingReader() {
+  unmap();
+}
+
+FrameRecording::Frame FrameRecordingReader::GetFrame(size_t idx) const {
+  if (idx >= m_recordOffsets.size()) {
+    throw std::out_of_range("Frame index out of range");
+  }
+  const unsigned char* cursor = m_data + m_recordOffsets[idx];
+  // Each record is preceded by its size, which the constructor checked against the file
+  uint32_t recordBytes;
+  std::memcpy(&recordBytes, cursor - sizeof(recordBytes), sizeof(recordBytes));
+  const unsigned char* end = cursor + recordBytes;
+
+  FrameRecording::Frame frame;
+  const FrameRecording::RecordHeader record = read<FrameRecording::RecordHeader>(cursor, end);
+  frame.timestamp = record.timestamp;
+  frame.frameId = record.frameId;
+  frame.serializedBytes = record.serializedBytes;
+  frame.serialized = skipPadded(cursor, end, record.serializedBytes);
+  frame.trackedQuad = read<FrameRecording::TrackedQuad>(cursor, end);
+
+  // every image takes at least its header, so a larger count can't be genuine
+  if (record.imageCount > remaining(cursor, end) / sizeof(FrameRecording::ImageHeader)) {
+    throw std::runtime_error("Corrupt frame recording: bad image count");
+  }
+  frame.images.resize(record.imageCount);
+  for (uint32_t i = 0; i < record.imageCount; i++) {
+    FrameRecording::Image& image = frame.images[i];
+    image.header = read<FrameRecording::ImageHeader>(cursor, end);
+    if (image.header.bytesPerPixel < 0) {
+      throw std::runtime_error("Corrupt frame recording: negative bytes per pixel");
+    }
+    const size_t imageBytes = arrayBytes(image.header.width, image.header.height, static_cast<size_t>(image.header.bytesPerPixel));
+    const size_t distortionBytes = arrayBytes(image.header.distortionWidth, image.header.distortionHeight, sizeof(float));
+    image.data = skipPadded(cursor, end, imageBytes);
+    image.distortion = reinterpret_cast<const float*>(skipPadded(cursor, end, distortionBytes));
+  }
+  return frame;
+}
+
+#if _WIN32
+
+void FrameRecordingReader::map(const std::string& path) {
+  m_fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (m_fileHandle == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("Unable to open frame recording: " + path);
+  }
+  LARGE_INTEGER size;
+  GetFileSizeEx(m_fileHandle, &size);
+  m_size = static_cast<size_t>(size.QuadPart);
+  m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (m_mappingHandle) {
+    m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+  }
+  if (!m_data) {
+    unmap();
+    throw std::runtime_error("Unable to map frame recording: " + path);
+  }
+}
+
+void FrameRecordingReader::unmap() {
+  if (m_data) {
+    UnmapViewOfFile(m_data);
+    m_data = nullptr;
+  }
+  if (m_mappingHandle) {
+    CloseHandle(m_mappingHandle);
+    m_mappingHandle = nullptr;
+  }
+  if (m_fileHandle != INVALID_HANDLE_VALUE) {
+    CloseHandle(m_fileHandle);
+    m_fileHandle = INVALID_HANDLE_VALUE;
+  }
+  m_size = 0;
+}
+
+#else
+
+void FrameRecordingReader::map(const std::string& path) {
+  m_fileDescriptor = open(path.c_str(), O_RDONLY);
+  if (m_fileDescriptor < 0) {
+    throw std::runtime_error("Unable to open frame recording: " + path);
+  }
+  struct stat info;
+  if (fstat(m_fileDescriptor, &info) != 0) {
+    unmap();
+    throw std::runtime_error("Unable to stat frame recording: " + path);
+  }
+  m_size = static_cast<size_t>(info.st_size);
+  void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+  if (data == MAP_FAILED) {
+    unmap();
+    throw std::runtime_error("Unable to map frame recording: " + path);
+  }
+  m_data = static_cast<const unsigned char*>(data);
+}
+
+void FrameRecordingReader::unmap() {
+  if (m_data) {
+    munmap(const_cast<unsigned char*>(m_data), m_size);
+    m_data = nullptr;
+  }
+  if (m_fileDescriptor >= 0) {
+    close(m_fileDescriptor);
+    m_fileDescriptor = -1;
+  }
+  m_size = 0;
+}
+
+#endif
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Leap.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A compact binary capture format for Leap frames, so that a tracking session
+// can be recorded once and replayed without a device.
+//
+// File layout (native byte order, every field 4-byte aligned):
+//
+//   FileHeader
+//   { uint32 recordBytes, RecordHeader, serialized frame, TrackedQuad, images }*
+//
+// The hands (palm and bone joints, widths, confidence, etc.) are stored using
+// Leap::Frame::serialize, so that a replayed frame can be fed through the same
+// pipeline as a live one.  The SDK does not serialize the tracked quad or the
+// images, so those are stored alongside it.  Each image stores its raw pixel
+// data followed by its distortion map.
+namespace FrameRecording {
+
+static const char MAGIC[4] = { 'L', 'M', 'F', 'R' };
+static const uint32_t VERSION = 1;
+
+enum Flags : uint32_t {
+  HAS_IMAGES = 1 << 0
+};
+
+struct FileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+struct RecordHeader {
+  int64_t timestamp;
+  int64_t frameId;
+  uint32_t serializedBytes;
+  uint32_t imageCount;
+};
+
+struct TrackedQuad {
+  uint8_t valid;
+  uint8_t visible;
+  uint8_t padding[2];
+  float width;
+  float height;
+  float position[3];
+  float orientation[9]; // column-major, columns are the x, y and z bases
+};
+
+struct ImageHeader {
+  int32_t id;
+  int32_t width;
+  int32_t height;
+  int32_t bytesPerPixel;
+  int32_t distortionWidth;
+  int32_t distortionHeight;
+};
+
+// A view of one image inside a mapped recording.
+struct Image {
+  ImageHeader header;
+  const unsigned char* data;
+  const float* distortion;
+};
+
+// A view of one frame inside a mapped recording.  The pointers remain valid for
+// the lifetime of the Reader that produced it.
+struct Frame {
+  int64_t timestamp;
+  int64_t frameId;
+  const unsigned char* serialized;
+  size_t serializedBytes;
+  TrackedQuad trackedQuad;
+  std::vector<Image> images;
+
+  Leap::Frame Deserialize() const;
+};
+
+}
+
+// Writes frames to a recording file as they arrive, without holding the session
+// in memory.  WriteFrame only encodes the frame; the file writes happen on a
+// background thread, so that a slow disk does not stall the caller.  A write
+// error on that thread is rethrown by the next WriteFrame or Flush.
+class FrameRecorder {
+public:
+
+  FrameRecorder(const std::string& path, bool recordImages);
+  ~FrameRecorder();
+
+  void WriteFrame(const Leap::Frame& frame);
+  // Blocks until every frame passed to WriteFrame so far is written to the file.
+  void Flush();
+
+  size_t FrameCount() const { return m_frameCount; }
+
+private:
+
+  FrameRecorder(const FrameRecorder&) = delete;
+  FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+  void writerMain();
+  void rethrowWriterError();
+
+  std::ofstream m_stream;
+  bool m_recordImages;
+  size_t m_frameCount;
+
+  /// These members are protected by m_mutex.
+  std::mutex m_mutex;
+  std::condition_variable m_pendingChanged;
+  std::deque<std::vector<unsigned char>> m_pending;
+  std::vector<std::vector<unsigned char>> m_spareBuffers;
+  bool m_writing;
+  bool m_stopping;
+  std::exception_ptr m_writerError;
+
+  std::thread m_writer;
+};
+
+// Memory-maps a recording file and indexes its frames.  Frames are decoded
+// lazily from the mapping, so opening a long recording is cheap.
+class FrameRecordingReader {
+public:
+
+  explicit FrameRecordingReader(const std::string& path);
+  ~FrameRecordingReader();
+
+  size_t FrameCount() const { return m_recordOffsets.size(); }
+  bool HasImages() const { return (m_flags & FrameRecording::HAS_IMAGES) != 0; }
+  FrameRecording::Frame GetFrame(size_t idx) const;
+
+private:
+
+  FrameRecordingReader(const FrameRecordingReader&) = delete;
+  FrameRecordingReader& operator=(const FrameRecordingReader&) = delete;
+
+  void map(const std::string& path);
+  void unmap();
+
+  const unsigned char* m_data;
+  size_t m_size;
+#if _WIN32
+  void* m_fileHandle;
+  void* m_mappingHandle;
+#else
+  int m_fileDescriptor;
+#endif
+  uint32_t m_flags;
+  std::vector<size_t> m_recordOffsets;
+};
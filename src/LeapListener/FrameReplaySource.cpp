@@ -0,0 +1,63 @@
+#include "stdafx.h"
+#include "FrameReplaySource.h"
+
+FrameReplaySource::FrameReplaySource(const std::string& path, Pacing pacing) :
+  m_reader(path),
+  m_pacing(pacing),
+  m_nextIdx(0),
+  m_started(false),
+  m_startTimestamp(0)
+{ }
+
+std::deque<Leap::Frame> FrameReplaySource::TakeAccumulatedFrames() {
+  std::deque<Leap::Frame> frames;
+  m_takenFrames.clear();
+  if (Finished()) {
+    return frames;
+  }
+
+  if (!m_started) {
+    m_startTime = std::chrono::steady_clock::now();
+    m_startTimestamp = m_reader.GetFrame(m_nextIdx).timestamp;
+    m_started = true;
+  }
+
+  if (m_pacing == Pacing::FULL_SPEED) {
+    m_takenFrames.push_back(m_reader.GetFrame(m_nextIdx++));
+  } else {
+    // Leap timestamps are in microseconds.
+    const int64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_startTime).count();
+    while (m_nextIdx < m_reader.FrameCount()) {
+      FrameRecording::Frame frame = m_reader.GetFrame(m_nextIdx);
+      if (frame.timestamp - m_startTimestamp > elapsed) {
+        break;
+      }
+      m_takenFrames.push_back(std::move(frame));
+      m_nextIdx++;
+    }
+  }
+
+  for (size_t i = 0; i < m_takenFrames.size(); i++) {
+    frames.push_back(m_takenFrames[i].Deserialize());
+  }
+  return frames;
+}
+
+bool FrameReplaySource::Finished() const {
+  return m_nextIdx >= m_reader.FrameCount();
+}
+
+const FrameRecording::TrackedQuad* FrameReplaySource::TrackedQuadForFrame(const Leap::Frame& frame) const {
+  const int64_t frameId = frame.id();
+  for (size_t i = 0; i < m_takenFrames.size(); i++) {
+    if (m_takenFrames[i].frameId == frameId) {
+      return &m_takenFrames[i].trackedQuad;
+    }
+  }
+  return nullptr;
+}
+
+const std::vector<FrameRecording::Image>& FrameReplaySource::LatestImages() const {
+  static const std::vector<FrameRecording::Image> noImages;
+  return m_takenFrames.empty() ? noImages : m_takenFrames.back().images;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "FrameRecording.h"
+#include <chrono>
+#include <deque>
+#include <memory>
+
+// Plays back a recording made by FrameRecorder, in place of a LeapListener.
+// TakeAccumulatedFrames has the same contract as LeapListener's, so replayed
+// frames go through the same pipeline as live ones.
+//
+// In FULL_SPEED mode every call yields exactly one recorded frame, which makes a
+// replay deterministic regardless of how long each iteration of the main loop
+// takes.  In REAL_TIME mode a call yields every frame whose recorded timestamp
+// has elapsed since the first call, reproducing the original pacing.
+class FrameReplaySource {
+public:
+
+  enum class Pacing { FULL_SPEED, REAL_TIME };
+
+  FrameReplaySource(const std::string& path, Pacing pacing);
+
+  std::deque<Leap::Frame> TakeAccumulatedFrames();
+
+  // True once every recorded frame has been taken.
+  bool Finished() const;
+
+  // The recorded data which the SDK does not serialize with the frame.  These
+  // are only valid for frames returned by the most recent TakeAccumulatedFrames.
+  const FrameRecording::TrackedQuad* TrackedQuadForFrame(const Leap::Frame& frame) const;
+  const std::vector<FrameRecording::Image>& LatestImages() const;
+
+  const FrameRecordingReader& Reader() const { return m_reader; }
+
+private:
+
+  FrameRecordingReader m_reader;
+  Pacing m_pacing;
+  size_t m_nextIdx;
+  bool m_started;
+  std::chrono::steady_clock::time_point m_startTime;
+  int64_t m_startTimestamp;
+  std::vector<FrameRecording::Frame> m_takenFrames;
+};
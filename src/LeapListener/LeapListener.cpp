@@ -1,9 +1,10 @@
 #include "stdafx.h"
 #include "LeapListener.h"
 
-LeapListener::LeapListener()
+LeapListener::LeapListener(size_t ringCapacity)
   :
-  m_isConnected(false)
+  m_isConnected(false),
+  m_frameRing(ringCapacity > 0 ? new DropOldestRingBuffer<Leap::Frame>(ringCapacity) : nullptr)
 { }
 
 LeapListener::~LeapListener() { }
@@ -19,6 +20,19 @@ const Leap::Frame &LeapListener::MostRecentFrame() const {
 }
 
 std::deque<Leap::Frame> LeapListener::TakeAccumulatedFrames() {
+  if (m_frameRing) {
+    std::deque<Leap::Frame> frames;
+    Leap::Frame frame;
+    while (m_frameRing->Pop(frame)) {
+      frames.push_back(frame);
+    }
+    if (!frames.empty()) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_mostRecentFrame = frames.back();
+    }
+    return frames;
+  }
+
   std::unique_lock<std::mutex> lock(m_mutex);
   std::deque<Leap::Frame> frames(std::move(m_accumulatedFrames));
   m_accumulatedFrames.clear();
@@ -44,7 +58,7 @@ void LeapListener::onConnect(const Leap::Controller& controller) {
 void LeapListener::onDisconnect(const Leap::Controller& controller) {
   std::unique_lock<std::mutex> lock(m_mutex);
 
-  m_accumulatedFrames.clear();
+  clearFrames();
   m_mostRecentFrame = Leap::Frame();
   m_isConnected = false;
 }
@@ -52,20 +66,35 @@ void LeapListener::onDisconnect(const Leap::Controller& controller) {
 void LeapListener::onFocusGained(const Leap::Controller& controller) {
   std::unique_lock<std::mutex> lock(m_mutex);
 
-  m_accumulatedFrames.clear();
+  clearFrames();
   m_mostRecentFrame = Leap::Frame();
 }
 
 void LeapListener::onFocusLost(const Leap::Controller& controller) {
   std::unique_lock<std::mutex> lock(m_mutex);
 
-  m_accumulatedFrames.clear();
+  clearFrames();
   m_mostRecentFrame = Leap::Frame();
 }
 
 void LeapListener::onFrame(const Leap::Controller& controller) {
+  if (m_frameRing) {
+    m_frameRing->Push(controller.frame());
+    return;
+  }
+
   std::unique_lock<std::mutex> lock(m_mutex);
 
   m_mostRecentFrame = controller.frame();
   m_accumulatedFrames.push_back(m_mostRecentFrame);
 }
+
+void LeapListener::clearFrames() {
+  m_accumulatedFrames.clear();
+  if (m_frameRing) {
+    // Discard from the producer side; the ring's read index is claimed atomically,
+    // so this is safe against a concurrent TakeAccumulatedFrames.
+    Leap::Frame discarded;
+    while (m_frameRing->Pop(discarded)) { }
+  }
+}
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "DropOldestRingBuffer.h"
 #include <deque>
 #include "Leap.h"
+#include <memory>
 #include <mutex>
 
 // TODO: make a "params" class for initializing a LeapListener (e.g. for
@@ -11,16 +13,29 @@
 // A small extension of the functionality of Leap::Listener which provides
 // access to some simple properties for convenience, such as retrieving the
 // most recent frame, an accumulated history of frames, or connection state.
+//
+// By default frames are accumulated in a mutex-protected deque.  If a nonzero
+// ring capacity is given, frames are instead handed off through a bounded
+// lock-free ring buffer, so that onFrame never blocks on the thread calling
+// TakeAccumulatedFrames (and vice versa).  When the ring is full, the oldest
+// frame is dropped.  In ring mode MostRecentFrame reflects the most recent
+// frame taken by TakeAccumulatedFrames.
 class LeapListener : public Leap::Listener {
 public:
 
-  LeapListener();
+  explicit LeapListener(size_t ringCapacity = 0);
   virtual ~LeapListener();
 
   bool IsConnected() const;
   const Leap::Frame &MostRecentFrame() const;
   std::deque<Leap::Frame> TakeAccumulatedFrames();
 
+  bool IsRingBufferMode() const { return static_cast<bool>(m_frameRing); }
+  // Ring buffer statistics.  These are all zero when not in ring buffer mode.
+  uint64_t DroppedFrameCount() const { return m_frameRing ? m_frameRing->DropCount() : 0; }
+  size_t RingOccupancy() const { return m_frameRing ? m_frameRing->Occupancy() : 0; }
+  uint64_t PeakRingOccupancy() const { return m_frameRing ? m_frameRing->PeakOccupancy() : 0; }
+
   virtual void onInit(const Leap::Controller&);
   virtual void onConnect(const Leap::Controller&);
   virtual void onDisconnect(const Leap::Controller&);
@@ -35,4 +50,9 @@ private:
   bool m_isConnected;
   Leap::Frame m_mostRecentFrame;
   std::deque<Leap::Frame> m_accumulatedFrames;
+
+  /// Only present in ring buffer mode.  Not protected by m_mutex.
+  std::unique_ptr<DropOldestRingBuffer<Leap::Frame>> m_frameRing;
+
+  void clearFrames();
 };
@@ -0,0 +1,89 @@
+#include "stdafx.h"
+#include "GeometryCache.h"
+
+#include <cassert>
+#include <cmath>
+#include <tuple>
+
+const double GeometryCache::QUANTUM = 1E-4;
+const double GeometryCache::ANGLE_QUANTUM = 2.0*M_PI/1024.0;
+
+GeometryCache::Key& GeometryCache::Key::Add(double value) {
+  m_Params.push_back(std::llround(value / QUANTUM));
+  return *this;
+}
+
+bool GeometryCache::Key::operator<(const Key& other) const {
+  return std::tie(m_Kind, m_Params) < std::tie(other.m_Kind, other.m_Params);
+}
+
+GeometryCache::GeometryCache(size_t byteBudget) : m_ByteBudget(byteBudget), m_Bytes(0) { }
+
+GeometryCache& GeometryCache::Shared() {
+  static GeometryCache cache;
+  return cache;
+}
+
+double GeometryCache::Quantize(double value) {
+  return std::round(value / QUANTUM) * QUANTUM;
+}
+
+double GeometryCache::QuantizeAngle(double radians) {
+  return std::round(radians / ANGLE_QUANTUM) * ANGLE_QUANTUM;
+}
+
+GeometryCache::MeshPtr GeometryCache::Get(const Key& key, const Generator& generate) {
+  auto found = m_Index.find(key);
+  if (found != m_Index.end()) {
+    // move the entry to the front of the LRU order
+    m_Entries.splice(m_Entries.begin(), m_Entries, found->second);
+    return found->second->m_Mesh;
+  }
+
+  PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
+  generate(mesh_assembler);
+  auto mesh = std::make_shared<PrimitiveGeometryMesh>();
+  mesh_assembler.InitializeMesh(*mesh);
+  assert(mesh->IsInitialized());
+
+  Entry entry = { key, mesh, mesh->BufferSize() };
+  m_Entries.push_front(entry);
+  m_Index[key] = m_Entries.begin();
+  m_Bytes += entry.m_Bytes;
+  Trim();
+  return mesh;
+}
+
+void GeometryCache::SetByteBudget(size_t byteBudget) {
+  m_ByteBudget = byteBudget;
+  Trim();
+}
+
+void GeometryCache::Trim() {
+  auto it = m_Entries.end();
+  while (m_Bytes > m_ByteBudget && it != m_Entries.begin()) {
+    --it;
+    // the cache's own reference is the only one if no primitive is using the mesh
+    if (it->m_Mesh.use_count() == 1) {
+      m_Bytes -= it->m_Bytes;
+      m_Index.erase(it->m_Key);
+      it = m_Entries.erase(it);
+    }
+  }
+  assert(IsConsistent());
+}
+
+bool GeometryCache::IsConsistent() const {
+  if (m_Index.size() != m_Entries.size()) {
+    return false;
+  }
+  size_t bytes = 0;
+  for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it) {
+    auto found = m_Index.find(it->m_Key);
+    if (found == m_Index.end() || found->second != it) {
+      return false;
+    }
+    bytes += it->m_Bytes;
+  }
+  return bytes == m_Bytes;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "PrimitiveGeometry.h"
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// A process-wide cache of the meshes of parameterized shapes (PartialDisk, PartialSphere, etc), keyed on the kind of
+// shape and the parameters it was generated from.  Primitives with the same parameters share one mesh, and a primitive
+// whose parameters change back to values seen recently gets the existing mesh back instead of generating a new one.
+//
+// Parameters are quantized (see Quantize and QuantizeAngle) before being used both in the key and for generating the
+// mesh, so that the mesh for a key doesn't depend on which primitive happened to generate it first.  Angles use a
+// coarser quantum than other parameters, so that a continuously animated angle revisits the same few keys: an angle
+// changing by less than ANGLE_QUANTUM per frame (about 0.46 rad/s at 75 Hz) keeps hitting the same mesh, and one
+// sweeping back and forth hits the meshes of its earlier sweeps.
+//
+// Meshes are reference counted via the shared_ptrs handed out by Get.  Meshes which no primitive holds any more are
+// kept for as long as the total size of the cached meshes is within the byte budget; when a new mesh would exceed it,
+// unused meshes are evicted, least recently used first.  Meshes still in use are never evicted, so the budget can be
+// exceeded while they are.  Like the GL state it manages, this must only be used from the thread that owns the GL
+// context.
+class GeometryCache {
+public:
+
+  typedef std::shared_ptr<const PrimitiveGeometryMesh> MeshPtr;
+  typedef std::function<void(PrimitiveGeometryMeshAssembler&)> Generator;
+
+  // Identifies a mesh by the kind of shape and the (quantized) parameters used to generate it.
+  class Key {
+  public:
+    explicit Key(const std::string& kind) : m_Kind(kind) { }
+    // Appends a parameter, which should already have been passed through Quantize or QuantizeAngle.
+    Key& Add(double value);
+    bool operator<(const Key& other) const;
+  private:
+    std::string m_Kind;
+    std::vector<long long> m_Params;
+  };
+
+  static const double QUANTUM;
+  // 1/1024 of a turn, so that multiples of pi/2 are exact.  Partial shapes have segments of about 0.1 radians, so the
+  // rounding is well below their tessellation error.
+  static const double ANGLE_QUANTUM;
+  static const size_t DEFAULT_BYTE_BUDGET = 16 << 20;
+
+  GeometryCache(size_t byteBudget = DEFAULT_BYTE_BUDGET);
+
+  // Returns the cache shared by all primitives.
+  static GeometryCache& Shared();
+  // Rounds a parameter to a multiple of QUANTUM.
+  static double Quantize(double value);
+  // Rounds an angle, in radians, to a multiple of ANGLE_QUANTUM.
+  static double QuantizeAngle(double radians);
+
+  // Returns the mesh for the given key, calling generate to fill a GL_TRIANGLES MeshAssembler if it isn't cached.
+  MeshPtr Get(const Key& key, const Generator& generate);
+
+  size_t ByteBudget() const { return m_ByteBudget; }
+  void SetByteBudget(size_t byteBudget);
+  // The total size of the GL buffers of the cached meshes, including those in use.
+  size_t Bytes() const { return m_Bytes; }
+  size_t MeshCount() const { return m_Entries.size(); }
+
+private:
+
+  struct Entry {
+    Key m_Key;
+    MeshPtr m_Mesh;
+    size_t m_Bytes;
+  };
+  typedef std::list<Entry> EntryList;
+
+  // Evicts unused meshes, least recently used first, until the cache is within its budget.
+  void Trim();
+  // Returns true iff the index and byte count agree with the entries.  Checked after each Trim in debug builds.
+  bool IsConsistent() const;
+
+  size_t m_ByteBudget;
+  size_t m_Bytes;
+  // Most recently used first.
+  EntryList m_Entries;
+  std::map<Key, EntryList::iterator> m_Index;
+};
@@ -0,0 +1,214 @@
+#include "stdafx.h"
+#include "InstancedBatch.h"
+
+#include <cstddef>
+
+namespace {
+
+void SetVertexAttribDivisor(GLuint location, GLuint divisor) {
+  if (GLEW_VERSION_3_3) {
+    glVertexAttribDivisor(location, divisor);
+  } else {
+    glVertexAttribDivisorARB(location, divisor);
+  }
+}
+
+void EnableInstanceAttribute(GLint location, GLint componentCount, GLsizei stride, size_t offset) {
+  if (location == -1) {
+    return;
+  }
+  glEnableVertexAttribArray(location);
+  glVertexAttribPointer(location, componentCount, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset));
+  SetVertexAttribDivisor(location, 1);
+}
+
+void DisableInstanceAttribute(GLint location) {
+  if (location == -1) {
+    return;
+  }
+  // other meshes may use this location for per-vertex attributes
+  SetVertexAttribDivisor(location, 0);
+  glDisableVertexAttribArray(location);
+}
+
+} // end of anonymous namespace
+
+InstancedBatch::InstancedBatch() {
+  SetShader(DefaultInstancedShader());
+}
+
+void InstancedBatch::Clear() {
+  for (int i = 0; i < NUM_MESH_TYPES; i++) {
+    m_Instances[i].clear();
+  }
+}
+
+void InstancedBatch::AddInstance(MeshType type, const EigenTypes::Matrix4x4& transform, const EigenTypes::Vector3& scale, const Leap::GL::Rgba<float>& color) {
+  m_Instances[type].push_back(Instance());
+  Instance& instance = m_Instances[type].back();
+  Eigen::Map<Eigen::Matrix4f>(instance.transform) = transform.cast<float>();
+  Eigen::Map<Eigen::Vector3f>(instance.scale) = scale.cast<float>();
+  instance.color[0] = color.R().Value();
+  instance.color[1] = color.G().Value();
+  instance.color[2] = color.B().Value();
+  instance.color[3] = color.A().Value();
+}
+
+void InstancedBatch::Add(const Sphere& sphere) {
+  AddInstance(SPHERE, localTransform(sphere), EigenTypes::Vector3::Constant(sphere.Radius()), sphere.Material().Uniform<AMBIENT_LIGHT_COLOR>());
+}
+
+void InstancedBatch::Add(const Disk& disk) {
+  AddInstance(DISK, localTransform(disk), EigenTypes::Vector3::Constant(disk.Radius()), disk.Material().Uniform<AMBIENT_LIGHT_COLOR>());
+}
+
+void InstancedBatch::Add(const Cylinder& cylinder) {
+  AddInstance(CYLINDER, localTransform(cylinder), EigenTypes::Vector3(cylinder.Radius(), cylinder.Height(), cylinder.Radius()), cylinder.Material().Uniform<AMBIENT_LIGHT_COLOR>());
+}
+
+void InstancedBatch::Add(const CapsulePrim& capsule) {
+  // the same three pieces that CapsulePrim::DrawContents draws
+  const EigenTypes::Matrix4x4 transform = localTransform(capsule);
+  const Leap::GL::Rgba<float>& color = capsule.Material().Uniform<AMBIENT_LIGHT_COLOR>();
+  const double radius = capsule.Radius();
+  const double halfHeight = 0.5*capsule.Height();
+  AddInstance(CAPSULE_BODY, transform, EigenTypes::Vector3(radius, capsule.Height(), radius), color);
+
+  EigenTypes::Matrix4x4 capTransform = transform;
+  capTransform.col(3) = transform * Eigen::Vector4d(0, -halfHeight, 0, 1);
+  AddInstance(CAPSULE_CAP, capTransform, EigenTypes::Vector3::Constant(radius), color);
+  capTransform.col(3) = transform * Eigen::Vector4d(0, halfHeight, 0, 1);
+  AddInstance(CAPSULE_CAP, capTransform, EigenTypes::Vector3(radius, -radius, radius), color);
+}
+
+size_t InstancedBatch::InstanceCount() const {
+  size_t count = 0;
+  for (int i = 0; i < NUM_MESH_TYPES; i++) {
+    count += m_Instances[i].size();
+  }
+  return count;
+}
+
+const std::shared_ptr<Leap::GL::Shader>& InstancedBatch::DefaultInstancedShader() {
+  static std::shared_ptr<Leap::GL::Shader> instancedShader = std::shared_ptr<Leap::GL::Shader>(new Leap::GL::Shader(Shaders::instancedVert, Shaders::instancedMaterialFrag));
+  return instancedShader;
+}
+
+bool InstancedBatch::IsSupported() {
+  return (GLEW_VERSION_3_3 || GLEW_ARB_instanced_arrays) && PrimitiveGeometryMesh::SupportsInstancedDraw();
+}
+
+void InstancedBatch::DrawContents(RenderState& renderState) const {
+  if (!IsSupported()) {
+    drawEachInstance();
+    return;
+  }
+
+  size_t offsets[NUM_MESH_TYPES];
+  m_Staging.clear();
+  for (int i = 0; i < NUM_MESH_TYPES; i++) {
+    offsets[i] = m_Staging.size();
+    m_Staging.insert(m_Staging.end(), m_Instances[i].begin(), m_Instances[i].end());
+  }
+  if (m_Staging.empty()) {
+    return;
+  }
+  drawInstanced(offsets);
+}
+
+void InstancedBatch::drawInstanced(const size_t offsets[NUM_MESH_TYPES]) const {
+  if (!m_InstanceBuffer.IsInitialized()) {
+    m_InstanceBuffer.Initialize(GL_ARRAY_BUFFER);
+  }
+  m_InstanceBuffer.Bind();
+  m_InstanceBuffer.BufferData(m_Staging.data(), static_cast<GLsizeiptr>(m_Staging.size()*sizeof(Instance)), GL_STREAM_DRAW);
+  m_InstanceBuffer.Unbind();
+
+  const Leap::GL::Shader &shader = Shader();
+  auto locations = std::make_tuple(shader.LocationOfAttribute("position"),
+                                   shader.LocationOfAttribute("normal"),
+                                   shader.LocationOfAttribute("tex_coord"),
+                                   shader.LocationOfAttribute("color"));
+  // a mat4 attribute takes up four consecutive locations, one per column
+  const GLint transformLocation = shader.LocationOfAttribute("instance_transform");
+  const GLint scaleLocation = shader.LocationOfAttribute("instance_scale");
+  const GLint colorLocation = shader.LocationOfAttribute("instance_color");
+  const GLsizei stride = static_cast<GLsizei>(sizeof(Instance));
+
+  for (int i = 0; i < NUM_MESH_TYPES; i++) {
+    const size_t count = m_Instances[i].size();
+    if (count == 0) {
+      continue;
+    }
+    const SharedPrimitiveGeometryMesh& mesh = meshFor(static_cast<MeshType>(i));
+    const size_t base = offsets[i]*sizeof(Instance);
+    mesh.Bind(locations);
+    m_InstanceBuffer.Bind();
+    for (int column = 0; column < 4; column++) {
+      EnableInstanceAttribute(transformLocation == -1 ? -1 : transformLocation + column, 4, stride, base + offsetof(Instance, transform) + 4*column*sizeof(float));
+    }
+    EnableInstanceAttribute(scaleLocation, 3, stride, base + offsetof(Instance, scale));
+    EnableInstanceAttribute(colorLocation, 4, stride, base + offsetof(Instance, color));
+    m_InstanceBuffer.Unbind();
+
+    mesh.DrawInstanced(static_cast<GLsizei>(count));
+
+    for (int column = 0; column < 4; column++) {
+      DisableInstanceAttribute(transformLocation == -1 ? -1 : transformLocation + column);
+    }
+    DisableInstanceAttribute(scaleLocation);
+    DisableInstanceAttribute(colorLocation);
+    mesh.Unbind(locations);
+  }
+}
+
+void InstancedBatch::drawEachInstance() const {
+  const Leap::GL::Shader &shader = Shader();
+  auto locations = std::make_tuple(shader.LocationOfAttribute("position"),
+                                   shader.LocationOfAttribute("normal"),
+                                   shader.LocationOfAttribute("tex_coord"),
+                                   shader.LocationOfAttribute("color"));
+  const GLint transformLocation = shader.LocationOfAttribute("instance_transform");
+  const GLint scaleLocation = shader.LocationOfAttribute("instance_scale");
+  const GLint colorLocation = shader.LocationOfAttribute("instance_color");
+
+  for (int i = 0; i < NUM_MESH_TYPES; i++) {
+    if (m_Instances[i].empty()) {
+      continue;
+    }
+    const SharedPrimitiveGeometryMesh& mesh = meshFor(static_cast<MeshType>(i));
+    mesh.Bind(locations);
+    // with their arrays disabled, the per-instance attributes take these constant values
+    for (const Instance& instance : m_Instances[i]) {
+      if (transformLocation != -1) {
+        for (int column = 0; column < 4; column++) {
+          glVertexAttrib4fv(transformLocation + column, instance.transform + 4*column);
+        }
+      }
+      if (scaleLocation != -1) {
+        glVertexAttrib3fv(scaleLocation, instance.scale);
+      }
+      if (colorLocation != -1) {
+        glVertexAttrib4fv(colorLocation, instance.color);
+      }
+      mesh.Draw();
+    }
+    mesh.Unbind(locations);
+  }
+}
+
+const SharedPrimitiveGeometryMesh& InstancedBatch::meshFor(MeshType type) {
+  switch (type) {
+  case SPHERE: return Sphere::UnitMesh();
+  case DISK: return Disk::UnitMesh();
+  case CYLINDER: return Cylinder::UnitMesh();
+  case CAPSULE_CAP: return CapsulePrim::CapMesh();
+  case CAPSULE_BODY: return CapsulePrim::BodyMesh();
+  default: break;
+  }
+  throw std::invalid_argument("invalid InstancedBatch::MeshType");
+}
+
+EigenTypes::Matrix4x4 InstancedBatch::localTransform(const PrimitiveBase& primitive) {
+  return SquareMatrixAdaptToDim<4>(primitive.LocalProperties().AffineTransform().AsFullMatrix(), EigenTypes::MATH_TYPE(1));
+}
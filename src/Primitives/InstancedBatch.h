@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Primitives.h"
+#include "Leap/GL/BufferObject.h"
+#include "Leap/GL/Rgba.h"
+#include <vector>
+
+// Draws many copies of the unit sphere, disk, cylinder and capsule meshes, each with its own
+// transform, scale and color, using one glDrawElementsInstanced call per kind of mesh.  The
+// meshes are the ones Sphere, Disk, Cylinder and CapsulePrim draw with.
+//
+// Instances are positioned relative to this node, and are kept until Clear is called, so a
+// batch filled once can be drawn several times (e.g. once per eye).  Each draw streams the
+// per-instance data into a buffer, which is respecified rather than updated in place so that
+// the driver doesn't have to wait for the previous draw to finish with it.
+//
+// The shader must take the per-instance attributes of Shaders::instancedVert.  The default
+// shader multiplies the material's ambient light color by each instance's color, so with the
+// default (white) ambient light color, the instance colors are used as given.  Where instanced
+// arrays aren't supported (see IsSupported), each instance is drawn with its own draw call
+// instead, with its per-instance attributes set as constant vertex attributes.
+class InstancedBatch : public PrimitiveBase {
+public:
+
+  enum MeshType { SPHERE, DISK, CYLINDER, CAPSULE_CAP, CAPSULE_BODY, NUM_MESH_TYPES };
+
+  InstancedBatch();
+  virtual ~InstancedBatch() { }
+
+  void Clear();
+
+  // The mesh is scaled by scale, then transformed by transform, which must be rigid or
+  // uniformly scaled.
+  void AddInstance(MeshType type, const EigenTypes::Matrix4x4& transform, const EigenTypes::Vector3& scale, const Leap::GL::Rgba<float>& color);
+
+  // These add the instances that the given primitive would draw, using its local transform
+  // (so it should be positioned in this node's coordinates), its size, and its material's
+  // ambient light color.  A capsule is three instances: its body and two caps.
+  void Add(const Sphere& sphere);
+  void Add(const Disk& disk);
+  void Add(const Cylinder& cylinder);
+  void Add(const CapsulePrim& capsule);
+
+  size_t InstanceCount() const;
+  size_t InstanceCount(MeshType type) const { return m_Instances[type].size(); }
+
+  // The instance colors may be translucent.
+  virtual bool HasTranslucentContents() const override { return true; }
+
+  static const std::shared_ptr<Leap::GL::Shader>& DefaultInstancedShader();
+
+  // Returns true iff the current GL context supports instanced arrays (OpenGL 3.3 or
+  // ARB_instanced_arrays), which DrawContents then uses to draw each kind of mesh at once.
+  static bool IsSupported();
+
+protected:
+
+  virtual void DrawContents(RenderState& renderState) const override;
+
+private:
+
+  // The layout of the per-instance vertex attributes.
+  struct Instance {
+    float transform[16]; // column-major
+    float scale[3];
+    float color[4];
+  };
+
+  void drawInstanced(const size_t offsets[NUM_MESH_TYPES]) const;
+  void drawEachInstance() const;
+
+  static const SharedPrimitiveGeometryMesh& meshFor(MeshType type);
+  static EigenTypes::Matrix4x4 localTransform(const PrimitiveBase& primitive);
+
+  std::vector<Instance> m_Instances[NUM_MESH_TYPES];
+  mutable std::vector<Instance> m_Staging; // all the instances, grouped by mesh type
+  mutable Leap::GL::BufferObject m_InstanceBuffer;
+};
@@ -66,6 +66,10 @@ public:
   void UploadUniforms () const {
     LambertianMaterialBaseClass::UploadUniforms(m_uniforms);
   }
+  // Uploads the given values (e.g. a snapshot taken earlier) instead of this material's.
+  void UploadUniforms (const UniformMap &uniforms) const {
+    LambertianMaterialBaseClass::UploadUniforms(uniforms);
+  }
 
 private:
 
@@ -4,6 +4,7 @@
 #include "LambertianMaterial.h"
 #include "Leap/GL/Shader.h"
 #include "Leap/GL/ShaderMatrices.h"
+#include "Leap/GL/UniformBufferRing.h"
 #include "SceneGraphNode.h"
 #include "SceneGraphNodeValues.h"
 #include "ShaderBindingScopeGuard.h"
@@ -11,6 +12,14 @@
 #include "utility/Shaders.h"
 //#include "Resource.h"
 
+namespace Leap {
+namespace GL {
+
+class Texture2;
+
+} // end of namespace GL
+} // end of namespace Leap
+
 // This is the base class for drawable, geometric primitives.  It inherits SceneGraphNode<...>
 // which provides the "scene graph" design pattern (see Wikipedia article on scene graph),
 // as well as some convenience methods.  The template parameter DIM allows 2D or 3D (or even
@@ -71,8 +80,11 @@ public:
     return *m_shader;
   }
 
+  // Where uniform buffers are available, the matrices and material are uploaded as uniform blocks.
   static const std::shared_ptr<Leap::GL::Shader>& DefaultShader() {
-    static std::shared_ptr<Leap::GL::Shader> defaultShader = std::shared_ptr<Leap::GL::Shader>(new Leap::GL::Shader(Shaders::transformedVert, Shaders::materialFrag));
+    static std::shared_ptr<Leap::GL::Shader> defaultShader = Leap::GL::UniformBufferRing::IsSupported()
+      ? std::shared_ptr<Leap::GL::Shader>(new Leap::GL::Shader(Shaders::transformedBlockVert, Shaders::materialBlockFrag))
+      : std::shared_ptr<Leap::GL::Shader>(new Leap::GL::Shader(Shaders::transformedVert, Shaders::materialFrag));
     return defaultShader;
   }
 
@@ -80,10 +92,25 @@ public:
   LambertianMaterial &Material () { return *m_material; }
 
   //Must be compatible with the default material (ie, use the same names for the matrix inputs)
+  // The material values carry over to the new shader.  Switching back to a shader this primitive
+  // has used before reuses its uniform bindings, so it costs no allocation and no GL queries.
   void SetShader(const std::shared_ptr<Leap::GL::Shader> &shader) {
     if (!shader) {
       throw std::runtime_error("Must specify a valid shader.");
     }
+    if (shader == m_shader) {
+      return;
+    }
+    for (const ShaderBinding &binding : m_shader_bindings) {
+      if (binding.shader == shader) {
+        binding.material->Uniforms() = m_material->Uniforms();
+        m_shader = binding.shader;
+        m_material = binding.material;
+        m_shader_matrices = binding.shader_matrices;
+        return;
+      }
+    }
+
     std::shared_ptr<LambertianMaterial> material;
     auto uniform_ids = LambertianMaterial::UniformIds("light_position", "diffuse_light_color", "ambient_light_color", "ambient_lighting_proportion", "use_texture", "texture");
     if (m_material) {
@@ -106,6 +133,7 @@ public:
     m_shader = shader;
     m_material = material;
     m_shader_matrices = std::make_shared<Leap::GL::ShaderMatrices>(m_shader.get());
+    m_shader_bindings.push_back(ShaderBinding{m_shader, m_material, m_shader_matrices});
   }
 
   typename Transform::ConstTranslationPart Translation () const { return this->LocalProperties().AffineTransform().translation(); }
@@ -139,11 +167,45 @@ public:
   // transformations (e.g. scaling based on a sphere's 'radius' member).
   virtual void MakeAdditionalModelViewTransformations (Leap::GL::ModelView &model_view) const { }
 
+  // The texture that DrawContents binds, if any.  A RenderList records it along with
+  // the material and transform, since the same primitive may be recorded several times
+  // with different textures.
+  virtual Leap::GL::Texture2 *ContentsTexture () const { return nullptr; }
+
+  // True iff DrawContents may draw translucent pixels even with an opaque material and
+  // no ContentsTexture, e.g. through textures or colors of its own.  A RenderList keeps
+  // such primitives in the order they were recorded instead of sorting them by state.
+  virtual bool HasTranslucentContents () const { return false; }
+
+  // Identifies the geometry that DrawContents draws, so that a RenderList can draw the
+  // primitives sharing a mesh one after another.
+  virtual const void *GeometryKey () const { return this; }
+
+  // Draws this primitive using state recorded earlier by a RenderList instead of its
+  // current state.  The model view matrix must already include the additional
+  // transformations, and the shader must already be bound.
+  void DrawRecorded(RenderState &render_state, const EigenTypes::Matrix4x4 &model_view, const LambertianMaterial::UniformMap &uniforms, Leap::GL::Texture2 *texture) const {
+    assert(m_shader);
+    assert(m_material);
+    assert(m_shader_matrices);
+
+    m_material->UploadUniforms(uniforms);
+    m_shader_matrices->UploadUniforms(model_view, render_state.ProjectionMatrix());
+
+    DrawContentsWithTexture(render_state, texture);
+  }
+
 protected:
 
   // This method should be overridden in each subclass to draw the particular geometry that it represents.
   virtual void DrawContents(RenderState &render_state) const = 0;
 
+  // As DrawContents, but with the given texture in place of ContentsTexture().  Subclasses
+  // which override ContentsTexture must override this as well.
+  virtual void DrawContentsWithTexture(RenderState &render_state, Leap::GL::Texture2 *texture) const {
+    DrawContents(render_state);
+  }
+
   // Temporary hack to allow multiple model-matrix primitives (CapsulePrim, BiCapsulePrim)
   void ManuallySetMatricesAndUploadMatrixUniforms (const EigenTypes::Matrix4x4 &model_view, const EigenTypes::Matrix4x4 &projection) const {
     m_shader_matrices->UploadUniforms(model_view, projection);
@@ -151,9 +213,18 @@ protected:
 
 private:
 
+  // The material and matrix bindings of a shader this primitive has used.
+  struct ShaderBinding {
+    std::shared_ptr<Leap::GL::Shader> shader;
+    std::shared_ptr<LambertianMaterial> material;
+    std::shared_ptr<Leap::GL::ShaderMatrices> shader_matrices;
+  };
+
   std::shared_ptr<Leap::GL::Shader> m_shader;
   std::shared_ptr<LambertianMaterial> m_material;
   std::shared_ptr<Leap::GL::ShaderMatrices> m_shader_matrices;
+  // Every shader set so far (including the current one), in the order they were first set.
+  std::vector<ShaderBinding> m_shader_bindings;
 };
 
 typedef Primitive<3> Primitive3;
@@ -21,45 +21,40 @@ void PrimitiveGeometry::PushUnitSphere(int widthResolution, int heightResolution
   const float heightStart = static_cast<float>(heightAngleStart);
   const float heightSweep = std::min(pi, static_cast<float>(heightAngleEnd - heightAngleStart));
 
+  auto SphereVertex = [](const EigenTypes::Vector3f &v, float texW, float texH) {
+    return PrimitiveGeometryMesh::VertexAttributes(v,                                 // position
+                                                   v.normalized(),                    // normal
+                                                   EigenTypes::Vector2f(texW, texH),  // texture coordinate
+                                                   EigenTypes::Vector4f(1, 1, 1, 1)); // color (opaque white)
+  };
+
+  // push the (widthResolution+1)*(heightResolution+1) grid of vertices, one meridian at a time
+  std::vector<GLuint> grid;
+  grid.reserve((widthResolution+1)*(heightResolution+1));
+  for (int w=0; w<=widthResolution; w++) {
+    const float wRatio = (w/resFloatW);
+    const float incW = wRatio * widthSweep + widthStart;
+    const float x = std::sin(incW);
+    const float y = std::cos(incW);
+    for (int h=0; h<=heightResolution; h++) {
+      const float hRatio = (h/resFloatH);
+      const float incH = hRatio * heightSweep + heightStart;
+      const float z = std::sin(incH);
+      const float r = std::cos(incH); // radius at this height
+      const EigenTypes::Vector3f v(r*x, z, r*y);
+      grid.push_back(mesh_assembler.PushIndexedVertex(SphereVertex(v, wRatio, hRatio)));
+    }
+  }
+
+  auto GridIndex = [&grid, heightResolution](int w, int h) { return grid[w*(heightResolution+1) + h]; };
   for (int w=0; w<widthResolution; w++) {
     for (int h=0; h<heightResolution; h++) {
-      const float wRatio1 = (w/resFloatW);
-      const float wRatio2 = ((w+1)/resFloatW);
-      const float hRatio1 = (h/resFloatH);
-      const float hRatio2 = ((h+1)/resFloatH);
-      const float inc1 = wRatio1 * widthSweep + widthStart;
-      const float inc2 = wRatio2 * widthSweep + widthStart;
-      const float inc3 = hRatio1 * heightSweep + heightStart;
-      const float inc4 = hRatio2 * heightSweep + heightStart;
-
-      // compute first position
-      const float x1 = std::sin(inc1);
-      const float y1 = std::cos(inc1);
-      const float z1 = std::sin(inc3);
-
-      // compute second position
-      const float x2 = std::sin(inc2);
-      const float y2 = std::cos(inc2);
-      const float z2 = std::sin(inc4);
-
-      // compute radii at these positions
-      const float r1 = std::cos(inc3);
-      const float r2 = std::cos(inc4);
-
-      // form triangles and compute their vertices
-      const EigenTypes::Vector3f v1(r1*x1, z1, r1*y1); // a
-      const EigenTypes::Vector3f v2(r1*x2, z1, r1*y2); // b
-      const EigenTypes::Vector3f v3(r2*x2, z2, r2*y2); // c
-      const EigenTypes::Vector3f v4(r2*x1, z2, r2*y1); // d
-
-      auto SphereVertex = [](const EigenTypes::Vector3f &v, float texW, float texH) {
-        return PrimitiveGeometryMesh::VertexAttributes(v,                                 // position
-                                                       v.normalized(),                    // normal
-                                                       EigenTypes::Vector2f(texW, texH),  // texture coordinate
-                                                       EigenTypes::Vector4f(1, 1, 1, 1)); // color (opaque white)
-      };
-      mesh_assembler.PushTriangle(SphereVertex(v1, wRatio1, hRatio1), SphereVertex(v2, wRatio2, hRatio1), SphereVertex(v3, wRatio2, hRatio2));
-      mesh_assembler.PushTriangle(SphereVertex(v1, wRatio1, hRatio1), SphereVertex(v3, wRatio2, hRatio2), SphereVertex(v4, wRatio1, hRatio2));
+      const GLuint a = GridIndex(w, h);
+      const GLuint b = GridIndex(w+1, h);
+      const GLuint c = GridIndex(w+1, h+1);
+      const GLuint d = GridIndex(w, h+1);
+      mesh_assembler.PushIndexedTriangle(a, b, c);
+      mesh_assembler.PushIndexedTriangle(a, c, d);
     }
   }
 }
@@ -79,56 +74,46 @@ void PrimitiveGeometry::PushUnitCylinder(int radialResolution, int verticalResol
   const float start = static_cast<float>(angleStart);
   const float sweep = std::min(twoPi, static_cast<float>(angleEnd - angleStart));
 
-  for (int w=0; w<radialResolution; w++) {
-    const float inc1 = w * radialRes * sweep + start;
-    const float inc2 = (w+1) * radialRes * sweep + start;
-
-    const float c1 = std::cos(inc1);
-    const float c2 = std::cos(inc2);
-    const float s1 = std::sin(inc1);
-    const float s2 = std::sin(inc2);
+  auto CylinderVertex = [](const EigenTypes::Vector3f &v, const EigenTypes::Vector3f &n) {
+    return PrimitiveGeometryMesh::VertexAttributes(v,                                 // position
+                                                   n,                                 // normal
+                                                   EigenTypes::Vector2f(0, 0),        // texture coordinate
+                                                   EigenTypes::Vector4f(1, 1, 1, 1)); // color (opaque white)
+  };
 
-    // vectors perpendicular from center axis to wall
-    const EigenTypes::Vector3f p1(c1, 0, s1);
-    const EigenTypes::Vector3f p2(c2, 0, s2);
+  // push the (radialResolution+1)*(verticalResolution+1) grid of vertices, one column at a time
+  std::vector<GLuint> grid;
+  grid.reserve((radialResolution+1)*(verticalResolution+1));
+  for (int w=0; w<=radialResolution; w++) {
+    const float inc = w * radialRes * sweep + start;
+    const float c = std::cos(inc);
+    const float s = std::sin(inc);
+
+    // vector perpendicular from center axis to wall
+    const EigenTypes::Vector3f p(c, 0, s);
+
+    // the normal is the same along the whole column
+    const EigenTypes::Vector3f tangent(EigenTypes::Vector3f((radiusTop-radiusBottom)*c, 1.0f, (radiusTop-radiusBottom)*s));
+    const EigenTypes::Vector3f binormal(p.cross(tangent));
+    const EigenTypes::Vector3f normal(tangent.cross(binormal).normalized());
+
+    for (int h=0; h<=verticalResolution; h++) {
+      const float ratio = h*verticalRes;
+      const float r = (1.0f-ratio)*radiusBottom + ratio*radiusTop;
+      const EigenTypes::Vector3f v(r*c, ratio - 0.5f, r*s);
+      grid.push_back(mesh_assembler.PushIndexedVertex(CylinderVertex(v, normal)));
+    }
+  }
 
+  auto GridIndex = [&grid, verticalResolution](int w, int h) { return grid[w*(verticalResolution+1) + h]; };
+  for (int w=0; w<radialResolution; w++) {
     for (int h=0; h<verticalResolution; h++) {
-      const float ratio1 = h*verticalRes;
-      const float ratio2 = (h+1)*verticalRes;
-
-      const float h1 = ratio1 - 0.5f;
-      const float h2 = ratio2 - 0.5f;
-
-      const float r1 = (1.0f-ratio1)*radiusBottom + ratio1*radiusTop;
-      const float r2 = (1.0f-ratio2)*radiusBottom + ratio2*radiusTop;
-
-      const EigenTypes::Vector3f v1(r1*c1, h1, r1*s1);
-      const EigenTypes::Vector3f v2(r2*c1, h2, r2*s1);
-      const EigenTypes::Vector3f v3(r1*c2, h1, r1*s2);
-      const EigenTypes::Vector3f v4(r2*c2, h2, r2*s2);
-
-      // tangents
-      const EigenTypes::Vector3f t1 = v2 - v1;
-      const EigenTypes::Vector3f t2 = v4 - v3;
-
-      // binormals
-      const EigenTypes::Vector3f b1 = (p1.cross(t1));
-      const EigenTypes::Vector3f b2 = (p2.cross(t2));
-
-      // normals
-      const EigenTypes::Vector3f n1 = t1.cross(b1).normalized();
-      const EigenTypes::Vector3f n2 = t2.cross(b2).normalized();
-
-      // geom.PushTri(MakeVertexAttributes(v1, n1), MakeVertexAttributes(v2, n1), MakeVertexAttributes(v3, n2));
-      // geom.PushTri(MakeVertexAttributes(v4, n2), MakeVertexAttributes(v3, n2), MakeVertexAttributes(v2, n1));
-      auto CylinderVertex = [](const EigenTypes::Vector3f &v, const EigenTypes::Vector3f &n) {
-        return PrimitiveGeometryMesh::VertexAttributes(v,                                 // position
-                                                       n,                                 // normal
-                                                       EigenTypes::Vector2f(0, 0),        // texture coordinate
-                                                       EigenTypes::Vector4f(1, 1, 1, 1)); // color (opaque white)
-      };
-      mesh_assembler.PushTriangle(CylinderVertex(v1, n1), CylinderVertex(v2, n1), CylinderVertex(v3, n2));
-      mesh_assembler.PushTriangle(CylinderVertex(v4, n2), CylinderVertex(v3, n2), CylinderVertex(v2, n1));
+      const GLuint v1 = GridIndex(w, h);
+      const GLuint v2 = GridIndex(w, h+1);
+      const GLuint v3 = GridIndex(w+1, h);
+      const GLuint v4 = GridIndex(w+1, h+1);
+      mesh_assembler.PushIndexedTriangle(v1, v2, v3);
+      mesh_assembler.PushIndexedTriangle(v4, v3, v2);
     }
   }
 }
@@ -159,12 +144,11 @@ void PrimitiveGeometry::PushUnitSquare(PrimitiveGeometryMeshAssembler& mesh_asse
   const EigenTypes::Vector3f normal(EigenTypes::Vector3f::UnitZ());
   const EigenTypes::Vector4f color(EigenTypes::Vector4f::Constant(1.0f)); // opaque white
 
-  mesh_assembler.PushTriangle(PrimitiveGeometryMesh::VertexAttributes(POSITIONS[0], normal, TEX_COORDS[0], color),
-                              PrimitiveGeometryMesh::VertexAttributes(POSITIONS[1], normal, TEX_COORDS[1], color),
-                              PrimitiveGeometryMesh::VertexAttributes(POSITIONS[2], normal, TEX_COORDS[2], color));
-  mesh_assembler.PushTriangle(PrimitiveGeometryMesh::VertexAttributes(POSITIONS[0], normal, TEX_COORDS[0], color),
-                              PrimitiveGeometryMesh::VertexAttributes(POSITIONS[2], normal, TEX_COORDS[2], color),
-                              PrimitiveGeometryMesh::VertexAttributes(POSITIONS[3], normal, TEX_COORDS[3], color));
+  GLuint indices[4];
+  for (int i=0; i<4; i++) {
+    indices[i] = mesh_assembler.PushIndexedVertex(PrimitiveGeometryMesh::VertexAttributes(POSITIONS[i], normal, TEX_COORDS[i], color));
+  }
+  mesh_assembler.PushIndexedQuad(indices[0], indices[1], indices[2], indices[3]);
 }
 
 void PrimitiveGeometry::PushUnitDisk(size_t resolution, PrimitiveGeometryMeshAssembler& mesh_assembler) {
@@ -182,24 +166,20 @@ void PrimitiveGeometry::PushUnitDisk(size_t resolution, PrimitiveGeometryMeshAss
     return PrimitiveGeometryMesh::VertexAttributes(p, normal, tex_coords, color);
   };
 
-  const EigenTypes::Vector3f center(EigenTypes::Vector3f::Zero());
+  const GLuint center = mesh_assembler.PushIndexedVertex(UnitDiskVertex(EigenTypes::Vector3f::Zero()));
 
   const float resFloat = static_cast<float>(resolution);
   const float twoPi = static_cast<float>(2.0 * M_PI);
 
+  // the rim vertices, the last of which is joined back up with the first
+  std::vector<GLuint> rim;
+  rim.reserve(resolution);
   for (size_t i=0; i<resolution; i++) {
-    const float inc1 = (i/resFloat) * twoPi;
-    const float inc2 = ((i+1)/resFloat) * twoPi;
-
-    const float c1 = std::cos(inc1);
-    const float c2 = std::cos(inc2);
-    const float s1 = std::sin(inc1);
-    const float s2 = std::sin(inc2);
-
-    const EigenTypes::Vector3f p1(c1, s1, 0.0f);
-    const EigenTypes::Vector3f p2(c2, s2, 0.0f);
-
-    mesh_assembler.PushTriangle(UnitDiskVertex(center), UnitDiskVertex(p1), UnitDiskVertex(p2));
+    const float inc = (i/resFloat) * twoPi;
+    rim.push_back(mesh_assembler.PushIndexedVertex(UnitDiskVertex(EigenTypes::Vector3f(std::cos(inc), std::sin(inc), 0.0f))));
+  }
+  for (size_t i=0; i<resolution; i++) {
+    mesh_assembler.PushIndexedTriangle(center, rim[i], rim[(i+1)%resolution]);
   }
 }
 
@@ -219,10 +199,12 @@ void PrimitiveGeometry::PushUnitBox(PrimitiveGeometryMeshAssembler& mesh_assembl
     const EigenTypes::Vector3f normal((p2-p1).cross(p0-p1).normalized());
     const EigenTypes::Vector2f tex_coords(EigenTypes::Vector2f::Zero());
     const EigenTypes::Vector4f color(EigenTypes::Vector4f::Constant(1.0f)); // opaque white
-    mesh_assembler.PushQuad(PrimitiveGeometryMesh::VertexAttributes(p0, normal, tex_coords, color),
-                            PrimitiveGeometryMesh::VertexAttributes(p1, normal, tex_coords, color),
-                            PrimitiveGeometryMesh::VertexAttributes(p2, normal, tex_coords, color),
-                            PrimitiveGeometryMesh::VertexAttributes(p3, normal, tex_coords, color));
+    // each face has its own vertices, since the normals differ from face to face
+    const GLuint i0 = mesh_assembler.PushIndexedVertex(PrimitiveGeometryMesh::VertexAttributes(p0, normal, tex_coords, color));
+    const GLuint i1 = mesh_assembler.PushIndexedVertex(PrimitiveGeometryMesh::VertexAttributes(p1, normal, tex_coords, color));
+    const GLuint i2 = mesh_assembler.PushIndexedVertex(PrimitiveGeometryMesh::VertexAttributes(p2, normal, tex_coords, color));
+    const GLuint i3 = mesh_assembler.PushIndexedVertex(PrimitiveGeometryMesh::VertexAttributes(p3, normal, tex_coords, color));
+    mesh_assembler.PushIndexedQuad(i0, i1, i2, i3);
   };
 
   // In order for this to be a unit box, its side lengths must be unit.
@@ -243,3 +225,73 @@ void PrimitiveGeometry::PushUnitBox(PrimitiveGeometryMeshAssembler& mesh_assembl
   PushUnitBoxQuad(p010, p110, p100, p000);
   PushUnitBoxQuad(p001, p101, p111, p011);
 }
+
+bool PrimitiveGeometry::CompactMeshesAreSupported() {
+  return Leap::GL::PackedVertexAttribute<GL_INT_2_10_10_10_REV>::IsSupported()
+      && Leap::GL::PackedVertexAttribute<GL_HALF_FLOAT>::IsSupported()
+      && Leap::GL::PackedVertexAttribute<GL_UNSIGNED_BYTE>::IsSupported();
+}
+
+void PrimitiveGeometry::InitializeCompactMesh(const PrimitiveGeometryMeshAssembler &mesh_assembler, CompactPrimitiveGeometryMesh &mesh) {
+  if (!CompactMeshesAreSupported()) {
+    throw Leap::GL::MeshException("CompactPrimitiveGeometryMesh requires OpenGL 3.3, or ARB_vertex_type_2_10_10_10_rev and ARB_half_float_vertex.");
+  }
+
+  const std::vector<PrimitiveGeometryMesh::VertexAttributes> &vertices = mesh_assembler.Vertices();
+  std::vector<CompactPrimitiveGeometryMesh::VertexAttributes> compact_vertices;
+  compact_vertices.reserve(vertices.size());
+  for (const PrimitiveGeometryMesh::VertexAttributes &v : vertices) {
+    compact_vertices.emplace_back(std::get<0>(v),
+                                  std::get<1>(v).ReinterpretAs<std::array<GLfloat,3>>(),
+                                  std::get<2>(v).ReinterpretAs<std::array<GLfloat,2>>(),
+                                  std::get<3>(v).ReinterpretAs<std::array<GLfloat,4>>());
+  }
+  if (mesh_assembler.IsIndexed()) {
+    const std::vector<GLuint> &indices = mesh_assembler.Indices();
+    mesh.Initialize(compact_vertices.data(), compact_vertices.size(), indices.data(), indices.size(), mesh_assembler.DrawMode());
+  } else {
+    mesh.Initialize(compact_vertices.data(), compact_vertices.size(), mesh_assembler.DrawMode());
+  }
+}
+
+void SharedPrimitiveGeometryMesh::Bind(AttributeLocations &attribute_locations) const {
+  if (UsesCompactMesh()) {
+    if (!m_compact_mesh.IsInitialized()) {
+      PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
+      m_push(mesh_assembler);
+      PrimitiveGeometry::InitializeCompactMesh(mesh_assembler, m_compact_mesh);
+    }
+    m_compact_mesh.Bind(attribute_locations);
+  } else {
+    if (!m_mesh.IsInitialized()) {
+      PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
+      m_push(mesh_assembler);
+      mesh_assembler.InitializeMesh(m_mesh);
+    }
+    m_mesh.Bind(attribute_locations);
+  }
+}
+
+void SharedPrimitiveGeometryMesh::Draw() const {
+  if (UsesCompactMesh()) {
+    m_compact_mesh.Draw();
+  } else {
+    m_mesh.Draw();
+  }
+}
+
+void SharedPrimitiveGeometryMesh::DrawInstanced(GLsizei instance_count) const {
+  if (UsesCompactMesh()) {
+    m_compact_mesh.DrawInstanced(instance_count);
+  } else {
+    m_mesh.DrawInstanced(instance_count);
+  }
+}
+
+void SharedPrimitiveGeometryMesh::Unbind(AttributeLocations &attribute_locations) const {
+  if (UsesCompactMesh()) {
+    m_compact_mesh.Unbind(attribute_locations);
+  } else {
+    m_mesh.Unbind(attribute_locations);
+  }
+}
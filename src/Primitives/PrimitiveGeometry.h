@@ -4,6 +4,7 @@
 #include "Leap/GL/BufferObject.h"
 #include "Leap/GL/Mesh.h"
 #include "Leap/GL/MeshAssembler.h"
+#include "Leap/GL/PackedVertexAttribute.h"
 #include "RenderState.h"
 
 #include <map>
@@ -27,17 +28,59 @@ typedef Leap::GL::MeshAssembler<Leap::GL::VertexAttribute<GL_FLOAT_VEC3>, // Pos
                                 Leap::GL::VertexAttribute<GL_FLOAT_VEC2>, // 2D texture coordinate
                                 Leap::GL::VertexAttribute<GL_FLOAT_VEC4>  // RGBA color
                                 > PrimitiveGeometryMeshAssembler;
+// The same attributes as PrimitiveGeometryMesh in 24 bytes per vertex instead of 48, for meshes whose normals are unit
+// length, texture coordinates need no more than half precision, and colors are 8 bits per channel.  Requires OpenGL 3.3
+// (see PrimitiveGeometry::CompactMeshesAreSupported, and SharedPrimitiveGeometryMesh for a fallback).
+typedef Leap::GL::Mesh<Leap::GL::VertexAttribute<GL_FLOAT_VEC3>,             // Position
+                       Leap::GL::PackedVertexAttribute<GL_INT_2_10_10_10_REV>, // Normal vector
+                       Leap::GL::PackedVertexAttribute<GL_HALF_FLOAT>,         // 2D texture coordinate
+                       Leap::GL::PackedVertexAttribute<GL_UNSIGNED_BYTE>       // RGBA color
+                       > CompactPrimitiveGeometryMesh;
 
 namespace PrimitiveGeometry {
 
 // TODO: make the PrimitiveGeometryMeshAssembler argument first.
 
 // Functions for populating a PrimitiveGeometryMeshAssembler object with some simple shapes.  These functions assume that
-// the draw mode of the mesh is GL_TRIANGLES.
+// the draw mode of the mesh is GL_TRIANGLES.  They push shared vertices and indices (see MeshAssembler::PushIndexedVertex),
+// so they can be combined with each other, but not with the unindexed Push* methods, in one MeshAssembler.
 void PushUnitSphere(int widthResolution, int heightResolution, PrimitiveGeometryMeshAssembler& mesh_assembler, double heightAngleStart = -M_PI/2.0, double heightAngleEnd = M_PI/2.0, double widthAngleStart = 0, double widthAngleEnd = 2.0*M_PI);
 void PushUnitCylinder(int radialResolution, int verticalResolution, PrimitiveGeometryMeshAssembler& mesh_assembler, float radiusBottom = 1.0f, float radiusTop = 1.0f, double angleStart = 0, double angleEnd = 2.0*M_PI);
 void PushUnitSquare(PrimitiveGeometryMeshAssembler &mesh_assembler);
 void PushUnitDisk(size_t resolution, PrimitiveGeometryMeshAssembler &mesh_assembler);
 void PushUnitBox(PrimitiveGeometryMeshAssembler &mesh_assembler);
 
+// Returns true iff the current GL context supports the packed attributes of CompactPrimitiveGeometryMesh.
+bool CompactMeshesAreSupported();
+// Like mesh_assembler.InitializeMesh(mesh), but packs the vertices into the compact format (keeping the indices, if the
+// assembler IsIndexed).  Throws Leap::GL::MeshException if !CompactMeshesAreSupported().
+void InitializeCompactMesh(const PrimitiveGeometryMeshAssembler &mesh_assembler, CompactPrimitiveGeometryMesh &mesh);
+
 } // end of namespace PrimitiveGeometry
+
+// A mesh shared by all instances of a primitive, stored as a CompactPrimitiveGeometryMesh where the current GL
+// context supports it, and as a PrimitiveGeometryMesh otherwise.  The format is chosen when the mesh is bound, and
+// the mesh is assembled (by the function given to the constructor) and uploaded in that format upon first use.
+class SharedPrimitiveGeometryMesh {
+public:
+
+  typedef PrimitiveGeometryMesh::VBO::AttributeLocations AttributeLocations;
+  // Pushes the mesh's shape into a GL_TRIANGLES assembler.
+  typedef void (*PushFunction)(PrimitiveGeometryMeshAssembler &mesh_assembler);
+
+  explicit SharedPrimitiveGeometryMesh(PushFunction push) : m_push(push) { }
+
+  // As the Mesh methods of the same names.  Draw, DrawInstanced and Unbind use the format that Bind chose.
+  void Bind(AttributeLocations &attribute_locations) const;
+  void Draw() const;
+  void DrawInstanced(GLsizei instance_count) const;
+  void Unbind(AttributeLocations &attribute_locations) const;
+
+  static bool UsesCompactMesh() { return PrimitiveGeometry::CompactMeshesAreSupported(); }
+
+private:
+
+  PushFunction m_push;
+  mutable PrimitiveGeometryMesh m_mesh;
+  mutable CompactPrimitiveGeometryMesh m_compact_mesh;
+};
@@ -21,14 +21,15 @@ void Sphere::MakeAdditionalModelViewTransformations (Leap::GL::ModelView &model_
   model_view.Scale(EigenTypes::Vector3::Constant(m_Radius));
 }
 
-void Sphere::DrawContents(RenderState& renderState) const {
-  static PrimitiveGeometryMesh mesh;
-  if (!mesh.IsInitialized()) {
-    PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
+const SharedPrimitiveGeometryMesh &Sphere::UnitMesh() {
+  static SharedPrimitiveGeometryMesh mesh([] (PrimitiveGeometryMeshAssembler &mesh_assembler) {
     PrimitiveGeometry::PushUnitSphere(96, 48, mesh_assembler);
-    mesh_assembler.InitializeMesh(mesh);
-    assert(mesh.IsInitialized());
-  }
+  });
+  return mesh;
+}
+
+void Sphere::DrawContents(RenderState& renderState) const {
+  const SharedPrimitiveGeometryMesh &mesh = UnitMesh();
   const Leap::GL::Shader &shader = Shader();
   auto locations = std::make_tuple(shader.LocationOfAttribute("position"),
                                    shader.LocationOfAttribute("normal"),
@@ -45,14 +46,15 @@ void Cylinder::MakeAdditionalModelViewTransformations (Leap::GL::ModelView &mode
   model_view.Scale(EigenTypes::Vector3(m_Radius, m_Height, m_Radius));
 }
 
-void Cylinder::DrawContents(RenderState& renderState) const {
-  static PrimitiveGeometryMesh mesh;
-  if (!mesh.IsInitialized()) {
-    PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
+const SharedPrimitiveGeometryMesh &Cylinder::UnitMesh() {
+  static SharedPrimitiveGeometryMesh mesh([] (PrimitiveGeometryMeshAssembler &mesh_assembler) {
     PrimitiveGeometry::PushUnitCylinder(50, 1, mesh_assembler);
-    mesh_assembler.InitializeMesh(mesh);
-    assert(mesh.IsInitialized());
-  }
+  });
+  return mesh;
+}
+
+void Cylinder::DrawContents(RenderState& renderState) const {
+  const SharedPrimitiveGeometryMesh &mesh = UnitMesh();
   const Leap::GL::Shader &shader = Shader();
   auto locations = std::make_tuple(shader.LocationOfAttribute("position"),
                                    shader.LocationOfAttribute("normal"),
@@ -93,14 +95,15 @@ void Disk::MakeAdditionalModelViewTransformations (Leap::GL::ModelView &model_vi
   model_view.Scale(EigenTypes::Vector3::Constant(m_Radius));
 }
 
-void Disk::DrawContents(RenderState& renderState) const {
-  static PrimitiveGeometryMesh mesh;
-  if (!mesh.IsInitialized()) {
-    PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
+const SharedPrimitiveGeometryMesh &Disk::UnitMesh() {
+  static SharedPrimitiveGeometryMesh mesh([] (PrimitiveGeometryMeshAssembler &mesh_assembler) {
     PrimitiveGeometry::PushUnitDisk(75, mesh_assembler);
-    mesh_assembler.InitializeMesh(mesh);
-    assert(mesh.IsInitialized());
-  }
+  });
+  return mesh;
+}
+
+void Disk::DrawContents(RenderState& renderState) const {
+  const SharedPrimitiveGeometryMesh &mesh = UnitMesh();
   const Leap::GL::Shader &shader = Shader();
   auto locations = std::make_tuple(shader.LocationOfAttribute("position"),
                                    shader.LocationOfAttribute("normal"),
@@ -118,6 +121,10 @@ void RectanglePrim::MakeAdditionalModelViewTransformations (Leap::GL::ModelView
 }
 
 void RectanglePrim::DrawContents(RenderState& renderState) const {
+  DrawContentsWithTexture(renderState, m_texture.get());
+}
+
+void RectanglePrim::DrawContentsWithTexture(RenderState& renderState, Leap::GL::Texture2* texture) const {
   static PrimitiveGeometryMesh mesh;
   if (!mesh.IsInitialized()) {
     PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
@@ -126,10 +133,10 @@ void RectanglePrim::DrawContents(RenderState& renderState) const {
     assert(mesh.IsInitialized());
   }
 
-  bool useTexture = bool(m_texture); // If there is a valid texture, enable texturing.
+  bool useTexture = texture != nullptr; // If there is a valid texture, enable texturing.
   if (useTexture) {
     glEnable(GL_TEXTURE_2D);
-    m_texture->Bind();
+    texture->Bind();
   }
   {
     const Leap::GL::Shader &shader = Shader();
@@ -143,7 +150,7 @@ void RectanglePrim::DrawContents(RenderState& renderState) const {
   }
   if (useTexture) {
     glDisable(GL_TEXTURE_2D);
-    m_texture->Unbind();
+    texture->Unbind();
   }
 }
 
@@ -180,54 +187,57 @@ void PartialDisk::DrawContents(RenderState& renderState) const {
                                    shader.LocationOfAttribute("normal"),
                                    shader.LocationOfAttribute("tex_coord"),
                                    shader.LocationOfAttribute("color"));
-  m_mesh.Bind(locations);
-  m_mesh.Draw();
-  m_mesh.Unbind(locations);
+  m_mesh->Bind(locations);
+  m_mesh->Draw();
+  m_mesh->Unbind(locations);
 }
 
 void PartialDisk::RecomputeMesh() const {
-  double sweepAngle = m_EndAngle - m_StartAngle;
-  if (sweepAngle > 2*M_PI) {
-    sweepAngle = 2*M_PI;
-  }
-
-  static const double DESIRED_ANGLE_PER_SEGMENT = 0.1; // radians
-  const int numSegments = static_cast<int>(sweepAngle / DESIRED_ANGLE_PER_SEGMENT) + 1;
-  const double anglePerSegment = sweepAngle / numSegments;
-
-  m_mesh.Shutdown();
-  PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
-
-  auto PartialDiskVertex = [](const EigenTypes::Vector3f &p) {
-    const EigenTypes::Vector3f normal(EigenTypes::Vector3f::UnitZ());
-    const EigenTypes::Vector2f tex_coords(EigenTypes::Vector2f::Zero());
-    const EigenTypes::Vector4f color(EigenTypes::Vector4f::Constant(1.0f)); // opaque white
-    return PrimitiveGeometryMesh::VertexAttributes(p, normal, tex_coords, color);
-  };
-
-  double curAngle = m_StartAngle;
-  const double cosStart = std::cos(m_StartAngle);
-  const double sinStart = std::sin(m_StartAngle);
-  EigenTypes::Vector3f prevInner(static_cast<float>(m_InnerRadius*cosStart), static_cast<float>(m_InnerRadius*sinStart), 0.0f);
-  EigenTypes::Vector3f prevOuter(static_cast<float>(m_OuterRadius*cosStart), static_cast<float>(m_OuterRadius*sinStart), 0.0f);
-  for (int i=0; i<numSegments; i++) {
-    curAngle += anglePerSegment;
-
-    const double cosCur = std::cos(curAngle);
-    const double sinCur = std::sin(curAngle);
-
-    const EigenTypes::Vector3f curInner(static_cast<float>(m_InnerRadius*cosCur), static_cast<float>(m_InnerRadius*sinCur), 0.0f);
-    const EigenTypes::Vector3f curOuter(static_cast<float>(m_OuterRadius*cosCur), static_cast<float>(m_OuterRadius*sinCur), 0.0f);
-
-    mesh_assembler.PushTriangle(PartialDiskVertex(prevInner), PartialDiskVertex(prevOuter), PartialDiskVertex(curOuter));
-    mesh_assembler.PushTriangle(PartialDiskVertex(curOuter), PartialDiskVertex(curInner), PartialDiskVertex(prevInner));
-
-    prevInner = curInner;
-    prevOuter = curOuter;
-  }
+  const double innerRadius = GeometryCache::Quantize(m_InnerRadius);
+  const double outerRadius = GeometryCache::Quantize(m_OuterRadius);
+  const double startAngle = GeometryCache::QuantizeAngle(m_StartAngle);
+  const double endAngle = GeometryCache::QuantizeAngle(m_EndAngle);
+  const GeometryCache::Key key = GeometryCache::Key("PartialDisk").Add(innerRadius).Add(outerRadius).Add(startAngle).Add(endAngle);
+
+  m_mesh = GeometryCache::Shared().Get(key, [=](PrimitiveGeometryMeshAssembler& mesh_assembler) {
+    double sweepAngle = endAngle - startAngle;
+    if (sweepAngle > 2*M_PI) {
+      sweepAngle = 2*M_PI;
+    }
 
-  mesh_assembler.InitializeMesh(m_mesh);
-  assert(m_mesh.IsInitialized());
+    static const double DESIRED_ANGLE_PER_SEGMENT = 0.1; // radians
+    const int numSegments = static_cast<int>(sweepAngle / DESIRED_ANGLE_PER_SEGMENT) + 1;
+    const double anglePerSegment = sweepAngle / numSegments;
+
+    auto PartialDiskVertex = [](const EigenTypes::Vector3f &p) {
+      const EigenTypes::Vector3f normal(EigenTypes::Vector3f::UnitZ());
+      const EigenTypes::Vector2f tex_coords(EigenTypes::Vector2f::Zero());
+      const EigenTypes::Vector4f color(EigenTypes::Vector4f::Constant(1.0f)); // opaque white
+      return PrimitiveGeometryMesh::VertexAttributes(p, normal, tex_coords, color);
+    };
+
+    double curAngle = startAngle;
+    const double cosStart = std::cos(startAngle);
+    const double sinStart = std::sin(startAngle);
+    // each vertex is shared by the quads on either side of it
+    GLuint prevInner = mesh_assembler.PushIndexedVertex(PartialDiskVertex(EigenTypes::Vector3f(static_cast<float>(innerRadius*cosStart), static_cast<float>(innerRadius*sinStart), 0.0f)));
+    GLuint prevOuter = mesh_assembler.PushIndexedVertex(PartialDiskVertex(EigenTypes::Vector3f(static_cast<float>(outerRadius*cosStart), static_cast<float>(outerRadius*sinStart), 0.0f)));
+    for (int i=0; i<numSegments; i++) {
+      curAngle += anglePerSegment;
+
+      const double cosCur = std::cos(curAngle);
+      const double sinCur = std::sin(curAngle);
+
+      const GLuint curInner = mesh_assembler.PushIndexedVertex(PartialDiskVertex(EigenTypes::Vector3f(static_cast<float>(innerRadius*cosCur), static_cast<float>(innerRadius*sinCur), 0.0f)));
+      const GLuint curOuter = mesh_assembler.PushIndexedVertex(PartialDiskVertex(EigenTypes::Vector3f(static_cast<float>(outerRadius*cosCur), static_cast<float>(outerRadius*sinCur), 0.0f)));
+
+      mesh_assembler.PushIndexedTriangle(prevInner, prevOuter, curOuter);
+      mesh_assembler.PushIndexedTriangle(curOuter, curInner, prevInner);
+
+      prevInner = curInner;
+      prevOuter = curOuter;
+    }
+  });
   m_RecomputeMesh = false;
 }
 
@@ -240,86 +250,95 @@ PartialDiskWithTriangle::PartialDiskWithTriangle()
 { }
 
 void PartialDiskWithTriangle::RecomputeMesh() const {
-  double sweepAngle = m_EndAngle - m_StartAngle;
-  if (sweepAngle > 2*M_PI) {
-    sweepAngle = 2*M_PI;
-  }
-
-  static const double DESIRED_ANGLE_PER_SEGMENT = 0.1; // radians
-  int numSegments = static_cast<int>(sweepAngle / DESIRED_ANGLE_PER_SEGMENT) + 1;
-  const double anglePerSegment = sweepAngle / numSegments;
-
-  m_mesh.Shutdown();
-  PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
-
-  auto PartialDiskVertex = [](const EigenTypes::Vector3f &p) {
-    const EigenTypes::Vector3f normal(EigenTypes::Vector3f::UnitZ());
-    const EigenTypes::Vector2f tex_coords(EigenTypes::Vector2f::Zero());
-    const EigenTypes::Vector4f color(EigenTypes::Vector4f::Constant(1.0f)); // opaque white
-    return PrimitiveGeometryMesh::VertexAttributes(p, normal, tex_coords, color);
-  };
-
-  double curAngle = m_StartAngle;
-  const double cosStart = std::cos(m_StartAngle);
-  const double sinStart = std::sin(m_StartAngle);
-  EigenTypes::Vector3f prevInner(static_cast<float>(m_InnerRadius*cosStart), static_cast<float>(m_InnerRadius*sinStart), 0.0f);
-  EigenTypes::Vector3f prevOuter(static_cast<float>(m_OuterRadius*cosStart), static_cast<float>(m_OuterRadius*sinStart), 0.0f);
-
-  bool haveStarted = false;
-  bool havePassedMidpoint = false;
-  bool havePassedEnd = false;
-  bool haveTakenCareOfExtraAngle = false;
-
-  const double triangleAngle = sweepAngle * m_TriangleWidth;
-  const double triangleStart = m_TrianglePosition * sweepAngle + m_StartAngle - triangleAngle / 2.0;
-  const double triangleEnd = triangleStart + triangleAngle;
-  const double triangleMidpoint = 0.5*(triangleStart + triangleEnd);
-
-  while (curAngle < (m_EndAngle - 0.001)) {
-    curAngle += anglePerSegment;
-
-    if (!haveStarted && curAngle > triangleStart) {
-      curAngle = triangleStart;
-      haveStarted = true;
-    } else if (!havePassedMidpoint && curAngle > triangleMidpoint) {
-      curAngle = triangleMidpoint;
-      havePassedMidpoint = true;
-    } else if (!havePassedEnd && curAngle > triangleEnd) {
-      curAngle = triangleEnd;
-      havePassedEnd = true;
-    } else if (havePassedEnd && !haveTakenCareOfExtraAngle) {
-      haveTakenCareOfExtraAngle = true;
-      curAngle = m_StartAngle + anglePerSegment * (static_cast<int>((curAngle-m_StartAngle) / anglePerSegment));
+  const double baseInnerRadius = GeometryCache::Quantize(m_InnerRadius);
+  const double baseOuterRadius = GeometryCache::Quantize(m_OuterRadius);
+  const double startAngle = GeometryCache::QuantizeAngle(m_StartAngle);
+  const double endAngle = GeometryCache::QuantizeAngle(m_EndAngle);
+  const TriangleSide triangleSide = m_TriangleSide;
+  const double trianglePosition = GeometryCache::Quantize(m_TrianglePosition);
+  const double triangleWidth = GeometryCache::Quantize(m_TriangleWidth);
+  const double triangleOffset = GeometryCache::Quantize(m_TriangleOffset);
+  GeometryCache::Key key("PartialDiskWithTriangle");
+  key.Add(baseInnerRadius).Add(baseOuterRadius).Add(startAngle).Add(endAngle);
+  key.Add(triangleSide).Add(trianglePosition).Add(triangleWidth).Add(triangleOffset);
+
+  m_mesh = GeometryCache::Shared().Get(key, [=](PrimitiveGeometryMeshAssembler& mesh_assembler) {
+    double sweepAngle = endAngle - startAngle;
+    if (sweepAngle > 2*M_PI) {
+      sweepAngle = 2*M_PI;
     }
 
-    double innerRadius = m_InnerRadius;
-    double outerRadius = m_OuterRadius;
-    if (curAngle >= triangleStart && curAngle <= triangleEnd) {
-      double ratio = (curAngle - triangleStart) / (triangleAngle);
-      double mult = -2 * std::abs(ratio-0.5) + 1;
-      const double triangleHeight = m_TriangleOffset * (m_OuterRadius - m_InnerRadius);
-      if (m_TriangleSide == INSIDE) {
-        innerRadius -= mult * triangleHeight;
-      } else if (m_TriangleSide == OUTSIDE) {
-        outerRadius += mult * triangleHeight;
+    static const double DESIRED_ANGLE_PER_SEGMENT = 0.1; // radians
+    int numSegments = static_cast<int>(sweepAngle / DESIRED_ANGLE_PER_SEGMENT) + 1;
+    const double anglePerSegment = sweepAngle / numSegments;
+
+    auto PartialDiskVertex = [](const EigenTypes::Vector3f &p) {
+      const EigenTypes::Vector3f normal(EigenTypes::Vector3f::UnitZ());
+      const EigenTypes::Vector2f tex_coords(EigenTypes::Vector2f::Zero());
+      const EigenTypes::Vector4f color(EigenTypes::Vector4f::Constant(1.0f)); // opaque white
+      return PrimitiveGeometryMesh::VertexAttributes(p, normal, tex_coords, color);
+    };
+
+    double curAngle = startAngle;
+    const double cosStart = std::cos(startAngle);
+    const double sinStart = std::sin(startAngle);
+    // each vertex is shared by the quads on either side of it
+    GLuint prevInner = mesh_assembler.PushIndexedVertex(PartialDiskVertex(EigenTypes::Vector3f(static_cast<float>(baseInnerRadius*cosStart), static_cast<float>(baseInnerRadius*sinStart), 0.0f)));
+    GLuint prevOuter = mesh_assembler.PushIndexedVertex(PartialDiskVertex(EigenTypes::Vector3f(static_cast<float>(baseOuterRadius*cosStart), static_cast<float>(baseOuterRadius*sinStart), 0.0f)));
+
+    bool haveStarted = false;
+    bool havePassedMidpoint = false;
+    bool havePassedEnd = false;
+    bool haveTakenCareOfExtraAngle = false;
+
+    const double triangleAngle = sweepAngle * triangleWidth;
+    const double triangleStart = trianglePosition * sweepAngle + startAngle - triangleAngle / 2.0;
+    const double triangleEnd = triangleStart + triangleAngle;
+    const double triangleMidpoint = 0.5*(triangleStart + triangleEnd);
+
+    while (curAngle < (endAngle - 0.001)) {
+      curAngle += anglePerSegment;
+
+      if (!haveStarted && curAngle > triangleStart) {
+        curAngle = triangleStart;
+        haveStarted = true;
+      } else if (!havePassedMidpoint && curAngle > triangleMidpoint) {
+        curAngle = triangleMidpoint;
+        havePassedMidpoint = true;
+      } else if (!havePassedEnd && curAngle > triangleEnd) {
+        curAngle = triangleEnd;
+        havePassedEnd = true;
+      } else if (havePassedEnd && !haveTakenCareOfExtraAngle) {
+        haveTakenCareOfExtraAngle = true;
+        curAngle = startAngle + anglePerSegment * (static_cast<int>((curAngle-startAngle) / anglePerSegment));
       }
-    }
 
-    const double cosCur = std::cos(curAngle);
-    const double sinCur = std::sin(curAngle);
+      double innerRadius = baseInnerRadius;
+      double outerRadius = baseOuterRadius;
+      if (curAngle >= triangleStart && curAngle <= triangleEnd) {
+        double ratio = (curAngle - triangleStart) / (triangleAngle);
+        double mult = -2 * std::abs(ratio-0.5) + 1;
+        const double triangleHeight = triangleOffset * (baseOuterRadius - baseInnerRadius);
+        if (triangleSide == INSIDE) {
+          innerRadius -= mult * triangleHeight;
+        } else if (triangleSide == OUTSIDE) {
+          outerRadius += mult * triangleHeight;
+        }
+      }
 
-    const EigenTypes::Vector3f curInner(static_cast<float>(innerRadius*cosCur), static_cast<float>(innerRadius*sinCur), 0.0f);
-    const EigenTypes::Vector3f curOuter(static_cast<float>(outerRadius*cosCur), static_cast<float>(outerRadius*sinCur), 0.0f);
+      const double cosCur = std::cos(curAngle);
+      const double sinCur = std::sin(curAngle);
 
-    mesh_assembler.PushTriangle(PartialDiskVertex(prevInner), PartialDiskVertex(prevOuter), PartialDiskVertex(curOuter));
-    mesh_assembler.PushTriangle(PartialDiskVertex(curOuter), PartialDiskVertex(curInner), PartialDiskVertex(prevInner));
+      const GLuint curInner = mesh_assembler.PushIndexedVertex(PartialDiskVertex(EigenTypes::Vector3f(static_cast<float>(innerRadius*cosCur), static_cast<float>(innerRadius*sinCur), 0.0f)));
+      const GLuint curOuter = mesh_assembler.PushIndexedVertex(PartialDiskVertex(EigenTypes::Vector3f(static_cast<float>(outerRadius*cosCur), static_cast<float>(outerRadius*sinCur), 0.0f)));
 
-    prevInner = curInner;
-    prevOuter = curOuter;
-  }
+      mesh_assembler.PushIndexedTriangle(prevInner, prevOuter, curOuter);
+      mesh_assembler.PushIndexedTriangle(curOuter, curInner, prevInner);
 
-  mesh_assembler.InitializeMesh(m_mesh);
-  assert(m_mesh.IsInitialized());
+      prevInner = curInner;
+      prevOuter = curOuter;
+    }
+  });
   m_RecomputeMesh = false;
 }
 
@@ -344,41 +363,48 @@ void PartialSphere::DrawContents(RenderState& renderState) const {
                                    shader.LocationOfAttribute("normal"),
                                    shader.LocationOfAttribute("tex_coord"),
                                    shader.LocationOfAttribute("color"));
-  m_mesh.Bind(locations);
-  m_mesh.Draw();
-  m_mesh.Unbind(locations);
+  m_mesh->Bind(locations);
+  m_mesh->Draw();
+  m_mesh->Unbind(locations);
 }
 
 void PartialSphere::RecomputeMesh() const {
-  static const double DESIRED_ANGLE_PER_SEGMENT = 0.1; // radians
-  const double heightSweep = std::min(M_PI, m_EndHeightAngle - m_StartHeightAngle);
-  const double widthSweep = std::min(2.0 * M_PI, m_EndWidthAngle - m_StartWidthAngle);
-  const int numWidth = static_cast<int>(widthSweep / DESIRED_ANGLE_PER_SEGMENT) + 1;
-  const int numHeight = static_cast<int>(heightSweep / DESIRED_ANGLE_PER_SEGMENT) + 1;
-  m_mesh.Shutdown();
-  PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
-  PrimitiveGeometry::PushUnitSphere(numWidth, numHeight, mesh_assembler, m_StartHeightAngle, m_EndHeightAngle, m_StartWidthAngle, m_EndWidthAngle);
-  mesh_assembler.InitializeMesh(m_mesh);
-  assert(m_mesh.IsInitialized());
+  const double startHeightAngle = GeometryCache::QuantizeAngle(m_StartHeightAngle);
+  const double endHeightAngle = GeometryCache::QuantizeAngle(m_EndHeightAngle);
+  const double startWidthAngle = GeometryCache::QuantizeAngle(m_StartWidthAngle);
+  const double endWidthAngle = GeometryCache::QuantizeAngle(m_EndWidthAngle);
+  const GeometryCache::Key key = GeometryCache::Key("PartialSphere").Add(startHeightAngle).Add(endHeightAngle).Add(startWidthAngle).Add(endWidthAngle);
+
+  m_mesh = GeometryCache::Shared().Get(key, [=](PrimitiveGeometryMeshAssembler& mesh_assembler) {
+    static const double DESIRED_ANGLE_PER_SEGMENT = 0.1; // radians
+    const double heightSweep = std::min(M_PI, endHeightAngle - startHeightAngle);
+    const double widthSweep = std::min(2.0 * M_PI, endWidthAngle - startWidthAngle);
+    const int numWidth = static_cast<int>(widthSweep / DESIRED_ANGLE_PER_SEGMENT) + 1;
+    const int numHeight = static_cast<int>(heightSweep / DESIRED_ANGLE_PER_SEGMENT) + 1;
+    PrimitiveGeometry::PushUnitSphere(numWidth, numHeight, mesh_assembler, startHeightAngle, endHeightAngle, startWidthAngle, endWidthAngle);
+  });
   m_RecomputeMesh = false;
 }
 
 CapsulePrim::CapsulePrim() : m_Radius(1), m_Height(1) { }
 
-void CapsulePrim::DrawContents(RenderState& renderState) const {
-  static bool loaded = false;
-  static PrimitiveGeometryMesh cap;
-  static PrimitiveGeometryMesh body;
-  if (!loaded) {
-    PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
+const SharedPrimitiveGeometryMesh &CapsulePrim::CapMesh() {
+  static SharedPrimitiveGeometryMesh cap([] (PrimitiveGeometryMeshAssembler &mesh_assembler) {
     PrimitiveGeometry::PushUnitSphere(24, 12, mesh_assembler, -M_PI/2.0, 0);
-    mesh_assembler.InitializeMesh(cap);
+  });
+  return cap;
+}
 
-    mesh_assembler.Initialize(GL_TRIANGLES); // This calls Shutdown first
+const SharedPrimitiveGeometryMesh &CapsulePrim::BodyMesh() {
+  static SharedPrimitiveGeometryMesh body([] (PrimitiveGeometryMeshAssembler &mesh_assembler) {
     PrimitiveGeometry::PushUnitCylinder(24, 1, mesh_assembler);
-    mesh_assembler.InitializeMesh(body);
-    loaded = true;
-  }
+  });
+  return body;
+}
+
+void CapsulePrim::DrawContents(RenderState& renderState) const {
+  const SharedPrimitiveGeometryMesh &cap = CapMesh();
+  const SharedPrimitiveGeometryMesh &body = BodyMesh();
 
   Leap::GL::ModelView& modelView = renderState.GetModelView();
 
@@ -439,9 +465,9 @@ void BiCapsulePrim::DrawContents(RenderState& renderState) const {
   modelView.Translate(EigenTypes::Vector3(0, (m_BodyOffset1+m_BodyOffset2)/2.0, 0));
   modelView.Scale(EigenTypes::Vector3(1.0, bodyHeight, 1.0));
   ManuallySetMatricesAndUploadMatrixUniforms(modelView.Matrix(), renderState.ProjectionMatrix());
-  m_Body.Bind(locations);
-  m_Body.Draw();
-  m_Body.Unbind(locations);
+  m_Body->Bind(locations);
+  m_Body->Draw();
+  m_Body->Unbind(locations);
   modelView.Pop();
 
   // draw first end cap
@@ -449,9 +475,9 @@ void BiCapsulePrim::DrawContents(RenderState& renderState) const {
   modelView.Translate(EigenTypes::Vector3(0, -m_Height/2.0, 0));
   modelView.Scale(EigenTypes::Vector3::Constant(m_Radius1));
   ManuallySetMatricesAndUploadMatrixUniforms(modelView.Matrix(), renderState.ProjectionMatrix());
-  m_Cap1.Bind(locations);
-  m_Cap1.Draw();
-  m_Cap1.Unbind(locations);
+  m_Cap1->Bind(locations);
+  m_Cap1->Draw();
+  m_Cap1->Unbind(locations);
   modelView.Pop();
 
   // draw second end cap
@@ -459,40 +485,37 @@ void BiCapsulePrim::DrawContents(RenderState& renderState) const {
   modelView.Translate(EigenTypes::Vector3(0, m_Height/2.0, 0));
   modelView.Scale(EigenTypes::Vector3(m_Radius2, -m_Radius2, m_Radius2));
   ManuallySetMatricesAndUploadMatrixUniforms(modelView.Matrix(), renderState.ProjectionMatrix());
-  m_Cap2.Bind(locations);
-  m_Cap2.Draw();
-  m_Cap2.Unbind(locations);
+  m_Cap2->Bind(locations);
+  m_Cap2->Draw();
+  m_Cap2->Unbind(locations);
   modelView.Pop();
 }
 
 void BiCapsulePrim::RecomputeMesh() const {
-  const double sideAngle = M_PI/2.0 - std::acos((m_Radius1 - m_Radius2)/m_Height);
+  const double sideAngle = GeometryCache::QuantizeAngle(M_PI/2.0 - std::acos((m_Radius1 - m_Radius2)/m_Height));
 
   const double sinSideAngle = std::sin(sideAngle);
   const double cosSideAngle = std::cos(sideAngle);
   m_BodyOffset1 = sinSideAngle * m_Radius1;
   m_BodyOffset2 = sinSideAngle * m_Radius2;
-  m_BodyRadius1 = cosSideAngle * m_Radius1;
-  m_BodyRadius2 = cosSideAngle * m_Radius2;
-
-  m_Cap1.Shutdown();
-  m_Cap2.Shutdown();
-  m_Body.Shutdown();
-
-  PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
-  PrimitiveGeometry::PushUnitSphere(24, 12, mesh_assembler, -M_PI/2.0, sideAngle);
-  mesh_assembler.InitializeMesh(m_Cap1);
-  assert(m_Cap1.IsInitialized());
-
-  mesh_assembler.Initialize(GL_TRIANGLES); // This calls Shutdown first.
-  PrimitiveGeometry::PushUnitSphere(24, 12, mesh_assembler, -M_PI/2.0, -sideAngle);
-  mesh_assembler.InitializeMesh(m_Cap2);
-  assert(m_Cap2.IsInitialized());
+  m_BodyRadius1 = GeometryCache::Quantize(cosSideAngle * m_Radius1);
+  m_BodyRadius2 = GeometryCache::Quantize(cosSideAngle * m_Radius2);
+
+  GeometryCache& cache = GeometryCache::Shared();
+  // the caps are unit partial spheres, and differ only in their end angle
+  auto Cap = [&cache](double endAngle) {
+    return cache.Get(GeometryCache::Key("BiCapsuleCap").Add(endAngle), [endAngle](PrimitiveGeometryMeshAssembler& mesh_assembler) {
+      PrimitiveGeometry::PushUnitSphere(24, 12, mesh_assembler, -M_PI/2.0, endAngle);
+    });
+  };
+  m_Cap1 = Cap(sideAngle);
+  m_Cap2 = Cap(-sideAngle);
 
-  mesh_assembler.Initialize(GL_TRIANGLES); // This calls Shutdown first.
-  PrimitiveGeometry::PushUnitCylinder(24, 1, mesh_assembler, static_cast<float>(m_BodyRadius1), static_cast<float>(m_BodyRadius2));
-  mesh_assembler.InitializeMesh(m_Body);
-  assert(m_Body.IsInitialized());
+  const float bodyRadius1 = static_cast<float>(m_BodyRadius1);
+  const float bodyRadius2 = static_cast<float>(m_BodyRadius2);
+  m_Body = cache.Get(GeometryCache::Key("BiCapsuleBody").Add(m_BodyRadius1).Add(m_BodyRadius2), [=](PrimitiveGeometryMeshAssembler& mesh_assembler) {
+    PrimitiveGeometry::PushUnitCylinder(24, 1, mesh_assembler, bodyRadius1, bodyRadius2);
+  });
 
   m_RecomputeMesh = false;
 }
@@ -518,25 +541,51 @@ void PartialCylinder::DrawContents(RenderState& renderState) const {
                                    shader.LocationOfAttribute("normal"),
                                    shader.LocationOfAttribute("tex_coord"),
                                    shader.LocationOfAttribute("color"));
-  m_mesh.Bind(locations);
-  m_mesh.Draw();
-  m_mesh.Unbind(locations);
+  m_mesh->Bind(locations);
+  m_mesh->Draw();
+  m_mesh->Unbind(locations);
 }
 
 void PartialCylinder::RecomputeMesh() const {
-  m_mesh.Shutdown();
-  PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
-  PrimitiveGeometry::PushUnitCylinder(30, 1, mesh_assembler, 1.0f, 1.0f, m_StartAngle, m_EndAngle);
-  mesh_assembler.InitializeMesh(m_mesh);
-  assert(m_mesh.IsInitialized());
+  const double startAngle = GeometryCache::QuantizeAngle(m_StartAngle);
+  const double endAngle = GeometryCache::QuantizeAngle(m_EndAngle);
+  const GeometryCache::Key key = GeometryCache::Key("PartialCylinder").Add(startAngle).Add(endAngle);
+
+  m_mesh = GeometryCache::Shared().Get(key, [=](PrimitiveGeometryMeshAssembler& mesh_assembler) {
+    PrimitiveGeometry::PushUnitCylinder(30, 1, mesh_assembler, 1.0f, 1.0f, startAngle, endAngle);
+  });
   m_RecomputeMesh = false;
 }
 
-RadialPolygonPrim::RadialPolygonPrim() : m_RecomputeMesh(true), m_Radius(1) { }
+RadialPolygonPrim::RadialPolygonPrim() : m_RecomputeSides(true), m_Radius(1) { }
+
+const PrimitiveGeometryMesh &RadialPolygonPrim::SideMesh() {
+  static PrimitiveGeometryMesh mesh;
+  if (!mesh.IsInitialized()) {
+    PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
+    PrimitiveGeometry::PushUnitCylinder(16, 1, mesh_assembler, 1.0f, 1.0f, 0.0, M_PI);
+    mesh_assembler.InitializeMesh(mesh);
+    assert(mesh.IsInitialized());
+  }
+  return mesh;
+}
+
+GeometryCache::MeshPtr RadialPolygonPrim::JointMesh(double angle) {
+  const double jointAngle = GeometryCache::QuantizeAngle(angle);
+  if (jointAngle <= 0) {
+    return GeometryCache::MeshPtr();
+  }
+  const GeometryCache::Key key = GeometryCache::Key("RadialPolygonJoint").Add(jointAngle);
+  return GeometryCache::Shared().Get(key, [=](PrimitiveGeometryMeshAssembler& mesh_assembler) {
+    static const double DESIRED_ANGLE_PER_SEGMENT = 0.1; // radians
+    const int numWidth = static_cast<int>(jointAngle / DESIRED_ANGLE_PER_SEGMENT) + 1;
+    PrimitiveGeometry::PushUnitSphere(numWidth, 16, mesh_assembler, -M_PI/2.0, M_PI/2.0, 0, jointAngle);
+  });
+}
 
 void RadialPolygonPrim::DrawContents(RenderState& renderState) const {
-  if (m_RecomputeMesh) {
-    RecomputeMesh();
+  if (m_RecomputeSides) {
+    RecomputeSides();
   }
 
   Leap::GL::ModelView& modelView = renderState.GetModelView();
@@ -547,52 +596,55 @@ void RadialPolygonPrim::DrawContents(RenderState& renderState) const {
                                    shader.LocationOfAttribute("tex_coord"),
                                    shader.LocationOfAttribute("color"));
 
-  // draw top polygon face
-  modelView.Push();
-  modelView.Translate(EigenTypes::Vector3(0, m_Radius, 0));
-  ManuallySetMatricesAndUploadMatrixUniforms(modelView.Matrix(), renderState.ProjectionMatrix());
-  // m_Polygon.Draw(Shader(), GL_TRIANGLES);
-  m_Polygon.Bind(locations);
-  m_Polygon.Draw();
-  m_Polygon.Unbind(locations);
-  modelView.Pop();
-
-  // draw bottom polygon face
-  modelView.Push();
-  modelView.Scale(EigenTypes::Vector3(1, -1, 1));
-  modelView.Translate(EigenTypes::Vector3(0, m_Radius, 0));
-  ManuallySetMatricesAndUploadMatrixUniforms(modelView.Matrix(), renderState.ProjectionMatrix());
-  m_Polygon.Bind(locations);
-  m_Polygon.Draw();
-  m_Polygon.Unbind(locations);
-  modelView.Pop();
+  // draw the top and bottom polygon faces, the bottom one mirrored from the top
+  if (m_FaceMesh.IsInitialized()) {
+    m_FaceMesh.Bind(locations);
+    for (int face=0; face<2; face++) {
+      modelView.Push();
+      if (face == 1) {
+        modelView.Scale(EigenTypes::Vector3(1, -1, 1));
+      }
+      modelView.Translate(EigenTypes::Vector3(0, m_Radius, 0));
+      ManuallySetMatricesAndUploadMatrixUniforms(modelView.Matrix(), renderState.ProjectionMatrix());
+      m_FaceMesh.Draw();
+      modelView.Pop();
+    }
+    m_FaceMesh.Unbind(locations);
+  }
 
   // draw each side consisting of a partial sphere and half-cylinder
   for (size_t i=0; i<m_Sides.size(); i++) {
+    const PrimitiveGeometryMesh* jointMesh = m_Sides[i].m_Joint.get();
+    if (!jointMesh) {
+      continue;
+    }
     modelView.Push();
     modelView.Translate(m_Sides[i].m_Origin);
     modelView.Multiply(m_Sides[i].m_SphereBasis);
     modelView.Scale(EigenTypes::Vector3::Constant(m_Radius));
     ManuallySetMatricesAndUploadMatrixUniforms(modelView.Matrix(), renderState.ProjectionMatrix());
-    m_Sides[i].m_SphereJoint.Bind(locations);
-    m_Sides[i].m_SphereJoint.Draw();
-    m_Sides[i].m_SphereJoint.Unbind(locations);
+    jointMesh->Bind(locations);
+    jointMesh->Draw();
+    jointMesh->Unbind(locations);
     modelView.Pop();
+  }
 
+  const PrimitiveGeometryMesh &sideMesh = SideMesh();
+  sideMesh.Bind(locations);
+  for (size_t i=0; i<m_Sides.size(); i++) {
     modelView.Push();
     modelView.Translate(m_Sides[i].m_Origin);
     modelView.Multiply(m_Sides[i].m_CylinderBasis);
     modelView.Scale(EigenTypes::Vector3(m_Radius, m_Sides[i].m_Length, m_Radius));
     modelView.Translate(EigenTypes::Vector3(0, 0.5, 0));
     ManuallySetMatricesAndUploadMatrixUniforms(modelView.Matrix(), renderState.ProjectionMatrix());
-    m_CylinderBody.Bind(locations);
-    m_CylinderBody.Draw();
-    m_CylinderBody.Unbind(locations);
+    sideMesh.Draw();
     modelView.Pop();
   }
+  sideMesh.Unbind(locations);
 }
 
-void RadialPolygonPrim::RecomputeMesh() const {
+void RadialPolygonPrim::RecomputeSides() const {
   // assumptions: 
   // - average of all polygon vertices lies within the shape
   // - the angle between any two sides is no greater than 180 degrees
@@ -604,8 +656,6 @@ void RadialPolygonPrim::RecomputeMesh() const {
     return;
   }
 
-
-
   // compute the centroid of the polygon
   EigenTypes::Vector3 avgPoint(EigenTypes::Vector3::Zero());
   for (int i=0; i<numPoints; i++) {
@@ -613,25 +663,25 @@ void RadialPolygonPrim::RecomputeMesh() const {
   }
   avgPoint /= numPoints;
 
-  // normal of the main face
-  const EigenTypes::Vector3 normal = EigenTypes::Vector3::UnitY();
-
-  auto PushPolygonTriangle = [](PrimitiveGeometryMeshAssembler &mesh_assembler,
-                                const EigenTypes::Vector3f &p0,
-                                const EigenTypes::Vector3f &p1,
-                                const EigenTypes::Vector3f &p2)
-  {
-    const EigenTypes::Vector3f normal((p2-p1).cross(p0-p1).normalized());
+  auto FaceVertex = [](const EigenTypes::Vector3& p) {
+    const EigenTypes::Vector3f normal(EigenTypes::Vector3f::UnitY());
     const EigenTypes::Vector2f tex_coords(EigenTypes::Vector2f::Zero());
     const EigenTypes::Vector4f color(EigenTypes::Vector4f::Constant(1.0f)); // opaque white
-    mesh_assembler.PushTriangle(PrimitiveGeometryMesh::VertexAttributes(p0, normal, tex_coords, color),
-                                PrimitiveGeometryMesh::VertexAttributes(p1, normal, tex_coords, color),
-                                PrimitiveGeometryMesh::VertexAttributes(p2, normal, tex_coords, color));
+    const EigenTypes::Vector3f position(p.cast<float>());
+    return PrimitiveGeometryMesh::VertexAttributes(position, normal, tex_coords, color);
   };
+  PrimitiveGeometryMeshAssembler faceAssembler(GL_TRIANGLES);
+  const GLuint center = faceAssembler.PushIndexedVertex(FaceVertex(avgPoint));
+  std::vector<GLuint> rim;
+  rim.reserve(numPoints);
+  for (int i=0; i<numPoints; i++) {
+    rim.push_back(faceAssembler.PushIndexedVertex(FaceVertex(m_Sides[i].m_Origin)));
+  }
+  bool haveFace = false;
+
+  // normal of the main face
+  const EigenTypes::Vector3 normal = EigenTypes::Vector3::UnitY();
 
-  m_Polygon.Shutdown();
-  PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
-  PrimitiveGeometryMeshAssembler sphere_joint_mesh_assembler;
   for (int i=0; i<numPoints; i++) {
     // retrieve the two polygon sides meeting at this point
     const EigenTypes::Vector3& curPoint = m_Sides[i].m_Origin;
@@ -659,16 +709,9 @@ void RadialPolygonPrim::RecomputeMesh() const {
     if (vec1.cross(vec2).y() < 0) {
       angle = 0;
     }
-    
-    // create partial sphere to join the two cylindrical sides
-    static const double DESIRED_ANGLE_PER_SEGMENT = 0.1; // radians
-    const int numWidth = static_cast<int>(angle / DESIRED_ANGLE_PER_SEGMENT) + 1;
-    m_Sides[i].m_SphereJoint.Shutdown();
-    sphere_joint_mesh_assembler.Initialize(GL_TRIANGLES);
-    PrimitiveGeometry::PushUnitSphere(numWidth, 16, sphere_joint_mesh_assembler, -M_PI/2.0, M_PI/2.0, 0, angle);
-    sphere_joint_mesh_assembler.InitializeMesh(m_Sides[i].m_SphereJoint);
-    assert(m_Sides[i].m_SphereJoint.IsInitialized());
-    sphere_joint_mesh_assembler.Shutdown();
+
+    // partial sphere to join the two cylindrical sides
+    m_Sides[i].m_Joint = JointMesh(angle);
 
     // compute bases of partial sphere and partial cylinder at this vertex
     const EigenTypes::Vector3 tangent = vec1.normalized();
@@ -682,22 +725,18 @@ void RadialPolygonPrim::RecomputeMesh() const {
     cylinderBasis.col(1) = -tangent;
     cylinderBasis.col(2) = binormal;
 
-    // add the vertex to the main face of the polygon
-    const EigenTypes::Vector3f p0 = nextPoint.cast<float>();
-    const EigenTypes::Vector3f p1 = avgPoint.cast<float>();
-    const EigenTypes::Vector3f p2 = curPoint.cast<float>();
-    PushPolygonTriangle(mesh_assembler, p0, p1, p2);
+    // this side's triangle of the fan, (nextPoint, avgPoint, curPoint), unless it's degenerate
+    if ((nextPoint - avgPoint).cross(curPoint - avgPoint).squaredNorm() > EPSILON*EPSILON) {
+      faceAssembler.PushIndexedTriangle(rim[(i+1)%numPoints], center, rim[i]);
+      haveFace = true;
+    }
   }
 
-  mesh_assembler.InitializeMesh(m_Polygon);
-  assert(m_Polygon.IsInitialized());
-
-  // create a single unit half-cylinder to be reused for all sides
-  m_CylinderBody.Shutdown();
-  mesh_assembler.Initialize(GL_TRIANGLES);
-  PrimitiveGeometry::PushUnitCylinder(16, 1, mesh_assembler, 1.0f, 1.0f, 0.0, M_PI);
-  mesh_assembler.InitializeMesh(m_CylinderBody);
-  assert(m_CylinderBody.IsInitialized());
+  if (haveFace) {
+    faceAssembler.InitializeMesh(m_FaceMesh);
+  } else if (m_FaceMesh.IsInitialized()) {
+    m_FaceMesh.Shutdown();
+  }
 
-  m_RecomputeMesh = false;
+  m_RecomputeSides = false;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "GeometryCache.h"
 #include "PrimitiveBase.h"
 #include "PrimitiveGeometry.h"
 #include "RenderState.h"
@@ -39,6 +40,11 @@ public:
 
   virtual void MakeAdditionalModelViewTransformations (Leap::GL::ModelView &model_view) const override;
 
+  virtual const void *GeometryKey () const override { return &UnitMesh(); }
+
+  // The unit sphere mesh shared by all Spheres and by InstancedBatch.
+  static const SharedPrimitiveGeometryMesh &UnitMesh();
+
 protected:
 
   virtual void DrawContents(RenderState& renderState) const override;
@@ -62,6 +68,11 @@ public:
 
   virtual void MakeAdditionalModelViewTransformations (Leap::GL::ModelView &model_view) const override;
 
+  virtual const void *GeometryKey () const override { return &UnitMesh(); }
+
+  // The unit cylinder mesh shared by all Cylinders and by InstancedBatch.
+  static const SharedPrimitiveGeometryMesh &UnitMesh();
+
 protected:
 
   virtual void DrawContents(RenderState& renderState) const override;
@@ -103,6 +114,11 @@ public:
 
   virtual void MakeAdditionalModelViewTransformations (Leap::GL::ModelView &model_view) const override;
 
+  virtual const void *GeometryKey () const override { return &UnitMesh(); }
+
+  // The unit disk mesh shared by all Disks and by InstancedBatch.
+  static const SharedPrimitiveGeometryMesh &UnitMesh();
+
 protected:
 
   virtual void DrawContents(RenderState& renderState) const override;
@@ -125,10 +141,12 @@ public:
   void SetTexture (const std::shared_ptr<Leap::GL::Texture2> &texture) { m_texture = texture; }
 
   virtual void MakeAdditionalModelViewTransformations (Leap::GL::ModelView &model_view) const override;
+  virtual Leap::GL::Texture2 *ContentsTexture () const override { return m_texture.get(); }
 
 protected:
 
   virtual void DrawContents(RenderState& renderState) const override;
+  virtual void DrawContentsWithTexture(RenderState& renderState, Leap::GL::Texture2* texture) const override;
 
 private:
 
@@ -194,8 +212,8 @@ protected:
 
   virtual void RecomputeMesh() const;
 
-  // cache the previously drawn geometry for speed if the primitive parameters are unchanged
-  mutable PrimitiveGeometryMesh m_mesh;
+  // the mesh for the current parameters, shared via GeometryCache with other primitives having the same parameters
+  mutable GeometryCache::MeshPtr m_mesh;
   mutable bool m_RecomputeMesh;
 
   double m_InnerRadius;
@@ -296,8 +314,8 @@ protected:
   virtual void DrawContents(RenderState& renderState) const override;
   virtual void RecomputeMesh() const;
 
-  // cache the previously drawn geometry for speed if the primitive parameters are unchanged
-  mutable PrimitiveGeometryMesh m_mesh;
+  // the mesh for the current parameters, shared via GeometryCache with other primitives having the same parameters
+  mutable GeometryCache::MeshPtr m_mesh;
   mutable bool m_RecomputeMesh;
 
   double m_Radius;
@@ -318,6 +336,11 @@ public:
   double Height() const { return m_Height; }
   void SetHeight(double height) { m_Height = height; }
 
+  // The meshes shared by all CapsulePrims and by InstancedBatch: a unit hemisphere
+  // (the bottom half, drawn mirrored for the top cap) and a unit cylinder.
+  static const SharedPrimitiveGeometryMesh &CapMesh();
+  static const SharedPrimitiveGeometryMesh &BodyMesh();
+
 protected:
 
   virtual void DrawContents(RenderState& renderState) const override;
@@ -364,10 +387,10 @@ protected:
 
 private:
 
-  // cache the previously drawn geometry for speed if the primitive parameters are unchanged
-  mutable PrimitiveGeometryMesh m_Cap1;
-  mutable PrimitiveGeometryMesh m_Cap2;
-  mutable PrimitiveGeometryMesh m_Body;
+  // shared via GeometryCache with other BiCapsulePrims having the same shape
+  mutable GeometryCache::MeshPtr m_Cap1;
+  mutable GeometryCache::MeshPtr m_Cap2;
+  mutable GeometryCache::MeshPtr m_Body;
 
   mutable bool m_RecomputeMesh;
   double m_Radius1;
@@ -414,8 +437,8 @@ protected:
   virtual void DrawContents(RenderState& renderState) const override;
   virtual void RecomputeMesh() const;
 
-  // cache the previously drawn geometry for speed if the primitive parameters are unchanged
-  mutable PrimitiveGeometryMesh m_mesh;
+  // the mesh for the current parameters, shared via GeometryCache with other primitives having the same parameters
+  mutable GeometryCache::MeshPtr m_mesh;
   mutable bool m_RecomputeMesh;
 
   double m_Radius;
@@ -424,6 +447,10 @@ protected:
   double m_EndAngle;
 };
 
+// A polygon in the XZ plane, thickened by Radius into a rounded slab.  The top and bottom faces
+// are one triangle fan around the centroid, rebuilt when the points move and drawn once per
+// face.  The rounded edges are drawn with shared unit meshes (a partial sphere per corner and a
+// half-cylinder per side), so moving the points only changes the transforms they're drawn with.
 class RadialPolygonPrim : public PrimitiveBase {
 public:
   RadialPolygonPrim();
@@ -432,7 +459,7 @@ public:
   void SetNumSides(size_t numSides) {
     if (numSides != m_Sides.size()) {
       m_Sides.resize(numSides);
-      m_RecomputeMesh = true;
+      m_RecomputeSides = true;
     }
   }
 
@@ -445,14 +472,20 @@ public:
     const EigenTypes::Vector3 newPoint(point.x(), 0, point.y());
     if ((newPoint - m_Sides[idx].m_Origin).squaredNorm() > CLOSENESS_THRESH) {
       m_Sides[idx].m_Origin = newPoint;
-      m_RecomputeMesh = true;
+      m_RecomputeSides = true;
     }
   }
 
+  // The shared meshes: a unit half-cylinder, and a unit partial sphere spanning the given angle
+  // around Y.  The joint meshes come from GeometryCache, with the angle quantized by
+  // GeometryCache::QuantizeAngle.  JointMesh returns null if the angle rounds to zero.
+  static const PrimitiveGeometryMesh &SideMesh();
+  static GeometryCache::MeshPtr JointMesh(double angle);
+
 protected:
 
   virtual void DrawContents(RenderState& renderState) const override;
-  virtual void RecomputeMesh() const;
+  virtual void RecomputeSides() const;
 
 private:
 
@@ -467,13 +500,15 @@ private:
     EigenTypes::Matrix3x3 m_SphereBasis;
     EigenTypes::Matrix3x3 m_CylinderBasis;
     double m_Length;
-    PrimitiveGeometryMesh m_SphereJoint;
+    // Null if the corner is concave, and so hidden inside the shape.
+    GeometryCache::MeshPtr m_Joint;
   };
 
-  mutable PrimitiveGeometryMesh m_CylinderBody;
   mutable std::vector<PerSideInfo, Eigen::aligned_allocator<PerSideInfo>> m_Sides;
-  mutable PrimitiveGeometryMesh m_Polygon;
-  mutable bool m_RecomputeMesh;
+  // The fan of the polygon's non-degenerate triangles around its centroid, in the XZ plane.
+  // Uninitialized if every triangle is degenerate.
+  mutable PrimitiveGeometryMesh m_FaceMesh;
+  mutable bool m_RecomputeSides;
 
   double m_Radius;
 };
@@ -0,0 +1,135 @@
+#include "stdafx.h"
+#include "RenderList.h"
+
+#include <algorithm>
+
+RenderList::RenderList() :
+  m_NumItems(0),
+  m_ShaderBindCount(0),
+  m_SortCount(0)
+{ }
+
+void RenderList::Begin() {
+  m_NumItems = 0;
+  m_Keys.clear();
+}
+
+void RenderList::Add(const PrimitiveBase& root, int layer) {
+  assert(m_Stack.empty());
+  // The cached global properties are relative to the root of the whole graph, so they
+  // can only be used when the given root is one.
+  const bool useCachedProperties = !root.HasParent();
+  m_Stack.push_back(StackEntry());
+  m_Stack.back().node = &root;
+  m_Stack.back().layer = layer;
+
+  while (!m_Stack.empty()) {
+    const StackEntry entry = m_Stack.back();
+    m_Stack.pop_back();
+    const PrimitiveBase& node = *entry.node;
+
+    PrimitiveBase::Properties composedProperties;
+    if (!useCachedProperties) {
+      composedProperties = entry.parentProperties;
+      composedProperties.Apply(node.LocalProperties(), Operate::ON_RIGHT);
+    }
+    const PrimitiveBase::Properties& globalProperties = useCachedProperties ? node.GlobalProperties() : composedProperties;
+
+    if (m_NumItems == m_Items.size()) {
+      m_Items.push_back(Item());
+    }
+    Item& item = m_Items[m_NumItems++];
+    item.primitive = &node;
+    item.texture = node.ContentsTexture();
+    Leap::GL::ModelView modelView;
+    modelView.Matrix() = SquareMatrixAdaptToDim<4>(globalProperties.AffineTransform().AsFullMatrix(), EigenTypes::MATH_TYPE(1));
+    node.MakeAdditionalModelViewTransformations(modelView);
+    item.transform = modelView.Matrix();
+    item.uniforms = node.Material().Uniforms();
+
+    SortKey key = SortKey();
+    key.layer = entry.layer;
+    key.translucent = node.HasTranslucentContents() || item.texture != nullptr
+      || item.uniforms.val<TEXTURE_MAPPING_ENABLED>() != GL_FALSE
+      || item.uniforms.val<DIFFUSE_LIGHT_COLOR>().A().Value() < 1.0f
+      || item.uniforms.val<AMBIENT_LIGHT_COLOR>().A().Value() < 1.0f;
+    if (!key.translucent) {
+      key.shader = reinterpret_cast<uintptr_t>(&node.Shader());
+      key.texture = reinterpret_cast<uintptr_t>(item.texture);
+      key.geometry = reinterpret_cast<uintptr_t>(node.GeometryKey());
+    }
+    m_Keys.push_back(key);
+
+    // push the children in reverse, so that they're visited (and recorded) in order
+    const PrimitiveBase::Parent_SceneGraphNode::ChildSet& children = node.Children();
+    for (auto it = children.rbegin(); it != children.rend(); ++it) {
+      assert(bool(*it));
+      assert(dynamic_cast<const PrimitiveBase*>(it->get()) != nullptr && "child isn't a PrimitiveBase");
+      m_Stack.push_back(StackEntry());
+      m_Stack.back().node = static_cast<const PrimitiveBase*>(it->get());
+      if (!useCachedProperties) {
+        m_Stack.back().parentProperties = globalProperties;
+      }
+      m_Stack.back().layer = entry.layer;
+    }
+  }
+}
+
+bool RenderList::SortKey::operator<(const SortKey& other) const {
+  if (layer != other.layer) {
+    return layer < other.layer;
+  }
+  if (translucent != other.translucent) {
+    return other.translucent;
+  }
+  // translucent items compare equal here, so the stable sort keeps them in order
+  if (shader != other.shader) {
+    return shader < other.shader;
+  }
+  if (texture != other.texture) {
+    return texture < other.texture;
+  }
+  return geometry < other.geometry;
+}
+
+void RenderList::End() {
+  if (m_Keys != m_SortedKeys) {
+    m_Order.resize(m_NumItems);
+    for (size_t i = 0; i < m_NumItems; i++) {
+      m_Order[i] = static_cast<uint32_t>(i);
+    }
+    const std::vector<SortKey>& keys = m_Keys;
+    std::stable_sort(m_Order.begin(), m_Order.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    m_SortedKeys = m_Keys;
+    m_SortCount++;
+  }
+
+  // the shaders of translucent items may change without their keys changing
+  m_ShaderBindCount = 0;
+  const Leap::GL::Shader* previousShader = nullptr;
+  for (uint32_t idx : m_Order) {
+    const Leap::GL::Shader* shader = &m_Items[idx].primitive->Shader();
+    if (shader != previousShader) {
+      m_ShaderBindCount++;
+      previousShader = shader;
+    }
+  }
+}
+
+void RenderList::Draw(RenderState& renderState) const {
+  assert(m_Order.size() == m_NumItems && "End must be called before Draw");
+  const EigenTypes::Matrix4x4 view = renderState.GetModelView().Matrix();
+  const Leap::GL::Shader* boundShader = nullptr;
+  for (uint32_t idx : m_Order) {
+    const Item& item = m_Items[idx];
+    const Leap::GL::Shader& shader = item.primitive->Shader();
+    if (&shader != boundShader) {
+      shader.Bind();
+      boundShader = &shader;
+    }
+    item.primitive->DrawRecorded(renderState, view * item.transform, item.uniforms, item.texture);
+  }
+  if (boundShader) {
+    Leap::GL::Shader::Unbind();
+  }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "PrimitiveBase.h"
+#include <cstdint>
+#include <vector>
+
+// A retained list of draw items, compiled from one or more scene graph subtrees.
+//
+// Each drawable node of an added subtree becomes an item holding everything needed
+// to draw it later: the primitive, its world transform (including any additional
+// model view transformations), a snapshot of its material uniforms, and the texture
+// it draws with.  Because the state is captured, the same primitive may be moved,
+// recolored and added again, which is how Scene draws repeated UI elements.
+//
+// Items added with a lower layer (see Add) are drawn first.  Within a layer, the
+// opaque items are drawn first, sorted by shader, then texture, then mesh, so that
+// items sharing state are drawn one after another.  The translucent items follow in
+// the order they were recorded, which is the order that PrimitiveBase::DrawSceneGraph
+// would draw them in, so they blend exactly as they would if drawn directly.  An item
+// is translucent if its material colors aren't fully opaque, if it draws with a
+// texture, or if its primitive says so (PrimitiveBase::HasTranslucentContents).
+// Consecutive items which share a shader share one shader bind.
+//
+// Compiling once and drawing once per eye is the intended use.  If a compile
+// produces the same sort keys as the previous one, the previous draw order is
+// reused.
+class RenderList {
+public:
+
+  RenderList();
+
+  // Starts a new compile, keeping the storage of the previous one.
+  void Begin();
+  // Adds every node of the subtree rooted at root, in scene graph order.  The root's
+  // parent transform is taken to be the identity.
+  void Add(const PrimitiveBase& root, int layer = 0);
+  // Finishes the compile, reordering the items if their sort keys changed.
+  void End();
+
+  // Draws the items in layer order, on top of the render state's model view matrix.
+  void Draw(RenderState& renderState) const;
+
+  size_t Size() const { return m_NumItems; }
+  // The number of shader binds that Draw performs.
+  size_t ShaderBindCount() const { return m_ShaderBindCount; }
+  // The number of compiles that needed their items reordered.
+  uint64_t SortCount() const { return m_SortCount; }
+
+private:
+
+  struct Item {
+    const PrimitiveBase* primitive;
+    Leap::GL::Texture2* texture;
+    EigenTypes::Matrix4x4 transform;
+    LambertianMaterial::UniformMap uniforms;
+  };
+
+  typedef std::vector<Item, Eigen::aligned_allocator<Item>> ItemVector;
+
+  // What an item is drawn in order of.  The state of translucent items is left zero,
+  // since they keep their recorded order.
+  struct SortKey {
+    int layer;
+    bool translucent;
+    uintptr_t shader;
+    uintptr_t texture;
+    uintptr_t geometry;
+
+    bool operator==(const SortKey& other) const {
+      return layer == other.layer && translucent == other.translucent && shader == other.shader && texture == other.texture && geometry == other.geometry;
+    }
+    bool operator<(const SortKey& other) const;
+  };
+
+  ItemVector m_Items; // only the first m_NumItems are in use
+  size_t m_NumItems;
+  std::vector<SortKey> m_Keys;
+  std::vector<SortKey> m_SortedKeys; // the keys that m_Order was computed for
+  std::vector<uint32_t> m_Order;
+  size_t m_ShaderBindCount;
+  uint64_t m_SortCount;
+
+  struct StackEntry {
+    const PrimitiveBase* node;
+    PrimitiveBase::Properties parentProperties;
+    int layer;
+  };
+  std::vector<StackEntry, Eigen::aligned_allocator<StackEntry>> m_Stack;
+};
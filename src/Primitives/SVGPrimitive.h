@@ -15,6 +15,8 @@ public:
   const EigenTypes::Vector2& Origin() const { return m_Origin; }
   const EigenTypes::Vector2& Size() const { return m_Size; }
 
+  virtual bool HasTranslucentContents() const override { return true; }
+
 protected:
 
   virtual void DrawContents(RenderState& renderState) const override;
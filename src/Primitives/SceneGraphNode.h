@@ -1,9 +1,11 @@
 #pragma once
 
 #include "utility/EigenTypes.h"
+#include <algorithm>
 #include <memory>
 #include "SceneGraphNodeProperties.h"
 #include <unordered_set>
+#include <vector>
 
 // This class contains base functionality common to all primitives:
 // - translation
@@ -90,17 +92,33 @@ public:
   > ChildSet;
 
   // This initializes all local properties to their respective identity values.
-  SceneGraphNode() { }
-  virtual ~SceneGraphNode() { }
+  SceneGraphNode() : m_global_properties_dirty(true), m_parent_node(nullptr) { }
+  virtual ~SceneGraphNode() {
+    // Any children which outlive this node become roots.
+    for (auto it = m_children.begin(); it != m_children.end(); ++it) {
+      if ((*it)->m_parent_node == this) {
+        (*it)->m_parent_node = nullptr;
+        (*it)->InvalidateGlobalProperties();
+      }
+    }
+  }
 
   using std::enable_shared_from_this<SceneGraphNode>::shared_from_this;
 
-  const std::shared_ptr<SceneGraphNode>& Parent () const { return m_parent.lock(); }
+  // This is empty if the parent isn't owned by a shared_ptr (see AddChild), even though
+  // HasParent is true.
+  std::shared_ptr<SceneGraphNode> Parent () const { return m_parent.lock(); }
+  bool HasParent () const { return m_parent_node != nullptr; }
   const ChildSet& Children() const { return m_children; }
   ChildSet& Children() { return m_children; }
 
   // these are virtual so that particular behavior can be added while adding/removing nodes.
   // any overrides should make sure to call the base class' version of the method, of course.
+  //
+  // A node may add children before it is owned by a shared_ptr (e.g. from its constructor,
+  // as SVGPrimitive does).  Such children still inherit this node's global properties, but
+  // their Parent() is empty, and the ancestry queries (RootNode, PropertiesDeltaTo, etc)
+  // stop at them.
   virtual void AddChild(std::shared_ptr<SceneGraphNode> child) {
     m_children.emplace_back(child);
     try {
@@ -108,28 +126,68 @@ public:
     } catch (const std::bad_weak_ptr&) {
       child->m_parent.reset(); // Unable to obtain weak pointer (parent most likely isn't a shared pointer)
     }
+    child->m_parent_node = this;
+    child->InvalidateGlobalProperties();
   }
   virtual void RemoveChild(std::shared_ptr<SceneGraphNode> child) {
     auto found = std::find(std::begin(m_children), std::end(m_children), child);
     if (found != std::end(m_children)) {
       m_children.erase(found);
+      // The child is now a root, so its global properties are just its local ones.
+      child->m_parent.reset();
+      child->m_parent_node = nullptr;
+      child->InvalidateGlobalProperties();
     }
   }
   virtual void RemoveFromParent() {
-    std::shared_ptr<SceneGraphNode> parent = m_parent.lock();
-    if (parent) {
+    if (m_parent_node) {
       try {
-        parent->RemoveChild(shared_from_this());
+        m_parent_node->RemoveChild(shared_from_this());
       } catch (const std::bad_weak_ptr&) {}
       m_parent.reset();
     }
   }
 
   // TODO: make iterator-based traversal
+  //
+  // Traversals which start at a root node (one without a parent) and use the identity
+  // as the parent's global properties use the cached global properties of each node,
+  // so unchanged subtrees cost nothing to recompute.  Otherwise the global properties
+  // are composed from the given ones as the traversal goes.
+  template <typename DerivedNode>
+  void DepthFirstTraverse (const std::function<void(const DerivedNode &node,
+                                                    const Properties &global_properties)> &callback) const {
+    if (HasParent()) {
+      DepthFirstTraverse(callback, Properties());
+      return;
+    }
+    assert(dynamic_cast<const DerivedNode *>(this) != nullptr && "this node isn't actually of the requested DerivedNode type");
+    callback(*static_cast<const DerivedNode *>(this), GlobalProperties());
+    for (auto it = m_children.begin(); it != m_children.end(); ++it) {
+      assert(bool(*it));
+      const SceneGraphNode &child = **it;
+      child.DepthFirstTraverseCached(callback);
+    }
+  }
+  template <typename DerivedNode>
+  void DepthFirstTraverse (const std::function<void(DerivedNode &node,
+                                                    const Properties &global_properties)> &callback) {
+    if (HasParent()) {
+      DepthFirstTraverse(callback, Properties());
+      return;
+    }
+    assert(dynamic_cast<DerivedNode *>(this) != nullptr && "this node isn't actually of the requested DerivedNode type");
+    callback(*static_cast<DerivedNode *>(this), GlobalProperties());
+    for (auto it = m_children.begin(); it != m_children.end(); ++it) {
+      assert(bool(*it));
+      SceneGraphNode &child = **it;
+      child.DepthFirstTraverseCached(callback);
+    }
+  }
   template <typename DerivedNode>
   void DepthFirstTraverse (const std::function<void(const DerivedNode &node,
                                                     const Properties &global_properties)> &callback,
-                           const Properties &parent_global_properties = Properties()) const {
+                           const Properties &parent_global_properties) const {
     // Using the parent's global properties, compute this node's global properties.
     Properties global_properties(parent_global_properties);
     global_properties.Apply(LocalProperties(), Operate::ON_RIGHT);
@@ -146,7 +204,7 @@ public:
   template <typename DerivedNode>
   void DepthFirstTraverse (const std::function<void(DerivedNode &node,
                                                     const Properties &global_properties)> &callback,
-                           const Properties &parent_global_properties = Properties()) {
+                           const Properties &parent_global_properties) {
     // Using the parent's global properties, compute this node's global properties.
     Properties global_properties(parent_global_properties);
     global_properties.Apply(LocalProperties(), Operate::ON_RIGHT);
@@ -189,9 +247,23 @@ public:
 
   // The local properties give this node's properties as a "delta" to its parents'.
   const Properties &LocalProperties () const { return m_local_properties; }
-  Properties &LocalProperties () { return m_local_properties; }
-  Properties GlobalProperties () const { return PropertiesDeltaToRootNode(); }
-  // TODO: (maybe) provide GlobalProperties method which applies the ancestor property stack
+  // Non-const access is taken to modify the local properties, so it invalidates the cached
+  // global properties of this node and its descendants (which is cheap if they already are).
+  // Read through the const accessors where possible.  The returned reference shouldn't be
+  // held on to across calls to GlobalProperties.
+  Properties &LocalProperties () {
+    InvalidateGlobalProperties();
+    return m_local_properties;
+  }
+  // The global properties are cached, and are only recomputed (from the parent's global
+  // properties, which are themselves cached) after this node or one of its ancestors has
+  // had its local properties modified or has been re-parented.
+  const Properties &GlobalProperties () const {
+    if (m_global_properties_dirty) {
+      ComputeGlobalProperties(m_parent_node ? m_parent_node->GlobalProperties() : Properties());
+    }
+    return m_global_properties;
+  }
 
   // This returns the "global properties" of this node, i.e. the composition
   // of the properties of the ancestor line of this node.
@@ -201,17 +273,7 @@ public:
   // the corresponding property in the return value will be the affine transformation
   // giving the transformation from this node's coordinate system to the global
   // coordinate system.
-  Properties PropertiesDeltaToRootNode () const {
-    Properties retval; // Initialized to the identity properties.
-    auto node = shared_from_this();
-    // Apply, on the left, each ancestor's local properties.  Continue
-    // until the root is reached.
-    do {
-      retval.Apply(node->LocalProperties(), Operate::ON_LEFT);
-      node = node->m_parent.lock();
-    } while (node);
-    return retval;
-  }
+  Properties PropertiesDeltaToRootNode () const { return GlobalProperties(); }
   // This returns the inverse of the PropertiesDeltaToRootNode() value.
   //
   // As an example, if one of the properties is the affine transformation giving
@@ -361,6 +423,47 @@ private:
   // template<typename... _Args>
   // static void CallFunction(std::nullptr_t, _Args&&...) {}
 
+  template <typename DerivedNode>
+  void DepthFirstTraverseCached (const std::function<void(const DerivedNode &node,
+                                                          const Properties &global_properties)> &callback) const {
+    // The parent has just been visited, so its global properties are up to date.
+    assert(dynamic_cast<const DerivedNode *>(this) != nullptr && "this node isn't actually of the requested DerivedNode type");
+    callback(*static_cast<const DerivedNode *>(this), GlobalProperties());
+    for (auto it = m_children.begin(); it != m_children.end(); ++it) {
+      assert(bool(*it));
+      const SceneGraphNode &child = **it;
+      child.DepthFirstTraverseCached(callback);
+    }
+  }
+  template <typename DerivedNode>
+  void DepthFirstTraverseCached (const std::function<void(DerivedNode &node,
+                                                          const Properties &global_properties)> &callback) {
+    assert(dynamic_cast<DerivedNode *>(this) != nullptr && "this node isn't actually of the requested DerivedNode type");
+    callback(*static_cast<DerivedNode *>(this), GlobalProperties());
+    for (auto it = m_children.begin(); it != m_children.end(); ++it) {
+      assert(bool(*it));
+      SceneGraphNode &child = **it;
+      child.DepthFirstTraverseCached(callback);
+    }
+  }
+
+  void ComputeGlobalProperties (const Properties &parent_global_properties) const {
+    m_global_properties = parent_global_properties;
+    m_global_properties.Apply(m_local_properties, Operate::ON_RIGHT);
+    m_global_properties_dirty = false;
+  }
+
+  // A dirty node's descendants are always dirty too (a node is only cleaned after its
+  // ancestors are), so the invalidation can stop at the first node which is already dirty.
+  void InvalidateGlobalProperties () {
+    if (!m_global_properties_dirty) {
+      m_global_properties_dirty = true;
+      for (auto it = m_children.begin(); it != m_children.end(); ++it) {
+        (*it)->InvalidateGlobalProperties();
+      }
+    }
+  }
+
   // This populates a vector with the ancestors of this node, starting with this node,
   // then its parent, then its parent's parent, etc (i.e. this node, going toward the root).
   void AppendAncestors (std::vector<std::shared_ptr<const SceneGraphNode>> &ancestors) const {
@@ -378,9 +481,16 @@ private:
   // Transform m_transform;
 
   Properties m_local_properties;
+  // The cached composition of the ancestors' local properties with this node's.
+  mutable Properties m_global_properties;
+  mutable bool m_global_properties_dirty;
 
   // This uses a weak_ptr to avoid a cycle of shared_ptrs which would then be indestructible.
   std::weak_ptr<SceneGraphNode> m_parent;
+  // The parent, also when it isn't owned by a shared_ptr.  The parent owns this node, and
+  // clears this when it removes this node or is destroyed.
+  SceneGraphNode *m_parent_node;
   // This is the set of all child nodes.
   ChildSet m_children;
 };
+
@@ -147,23 +147,24 @@ void TexturedFrame::RecomputeMeshIfNecessary() const {
   //    [0][2]    [1][2]    [2][2]    [3][2]
   //    [0][1]    [1][1]    [2][1]    [3][1]
   //    [0][0]    [1][0]    [2][0]    [3][0]
-  PrimitiveGeometryMesh::VertexAttributes vertex_attributes[4][4];
+  PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
+  GLuint vertex_indices[4][4];
   for (size_t u = 0; u < 4; ++u) {
     for (size_t v = 0; v < 4; ++v) {
-      vertex_attributes[u][v] = std::make_tuple(EigenTypes::Vector3f(static_cast<float>(rectangle_edge[0][u]), static_cast<float>(rectangle_edge[1][v]), 0.0f),
-                                                NORMAL,
-                                                EigenTypes::Vector2f(rectangle_edge_texture_coordinate[0][u], rectangle_edge_texture_coordinate[1][v]),
-                                                COLOR);
+      vertex_indices[u][v] = mesh_assembler.PushIndexedVertex(
+        std::make_tuple(EigenTypes::Vector3f(static_cast<float>(rectangle_edge[0][u]), static_cast<float>(rectangle_edge[1][v]), 0.0f),
+                        NORMAL,
+                        EigenTypes::Vector2f(rectangle_edge_texture_coordinate[0][u], rectangle_edge_texture_coordinate[1][v]),
+                        COLOR));
     }
   }
 
-  PrimitiveGeometryMeshAssembler mesh_assembler(GL_TRIANGLES);
   for (size_t u = 0; u < 3; ++u) {
     for (size_t v = 0; v < 3; ++v) {
-      mesh_assembler.PushQuad(vertex_attributes[u+0][v+0],
-                              vertex_attributes[u+1][v+0],
-                              vertex_attributes[u+1][v+1],
-                              vertex_attributes[u+0][v+1]);
+      mesh_assembler.PushIndexedQuad(vertex_indices[u+0][v+0],
+                                     vertex_indices[u+1][v+0],
+                                     vertex_indices[u+1][v+1],
+                                     vertex_indices[u+0][v+1]);
     }
   }
   mesh_assembler.InitializeMesh(m_mesh);
@@ -107,6 +107,8 @@ public:
   void SetRectangleEdgeTextureCoordinate (Rectangle rect, RectangleEdge edge, float tex_coord);
   // Set the texture for this primitive.  The texture coordinates will be unchanged.
   void SetTexture (const std::shared_ptr<Leap::GL::Texture2> &texture) { m_texture = texture; }
+
+  virtual bool HasTranslucentContents () const override { return true; }
   
 protected:
 
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "TextPrimitive.h"
+#include "Leap/GL/StateCache.h"
 #include "utility/Shaders.h"
 
 TextPrimitive::TextPrimitive() : m_size(EigenTypes::Vector2::Zero()), m_atlasID(0) { }
@@ -22,7 +23,7 @@ void TextPrimitive::DrawContents(RenderState& renderState) const {
   if (Material().Uniform<AMBIENT_LIGHT_COLOR>().A() < 0.0001f) {
     return;
   }
-  glBindTexture(GL_TEXTURE_2D, m_atlasID);
+  Leap::GL::StateCache::Current().BindTexture(0, GL_TEXTURE_2D, m_atlasID);
   const Leap::GL::Shader &shader = Shader();
   auto locations = std::make_tuple(shader.LocationOfAttribute("position"),
                                    shader.LocationOfAttribute("normal"),
@@ -31,7 +32,7 @@ void TextPrimitive::DrawContents(RenderState& renderState) const {
   m_mesh.Bind(locations);
   m_mesh.Draw();
   m_mesh.Unbind(locations);
-  glBindTexture(GL_TEXTURE_2D, 0);
+  Leap::GL::StateCache::Current().BindTexture(0, GL_TEXTURE_2D, 0);
 }
 
 std::shared_ptr<Leap::GL::Shader> TextPrimitive::getFontShader() const {
@@ -10,6 +10,7 @@ public:
   TextPrimitive();
   void SetText(const std::wstring& text, const std::shared_ptr<TextureFont>& font);
   const EigenTypes::Vector2& Size() const { return m_size; }
+  virtual bool HasTranslucentContents() const override { return true; }
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 protected:
   virtual void DrawContents(RenderState& renderState) const override;
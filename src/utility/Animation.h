@@ -170,6 +170,41 @@ public:
     }
   }
 
+  // Equivalent to calling Update(deltaTime) numSteps times with the goal held
+  // fixed, but in constant time.  Used to catch up on skipped frames.
+  //
+  // Each Update multiplies the offsets from the goal by the same lower-triangular
+  // matrix s*(I - (1-s)*L)^-1, where L shifts down by one iteration.  Its n-th
+  // power is s^n * sum_m C(n+m-1, m) (1-s)^m L^m, so every value becomes a
+  // weighted sum of the current values and the goal.
+  void Update(float deltaTime, int numSteps) {
+    if (numSteps <= 1) {
+      if (numSteps == 1) {
+        Update(deltaTime);
+      }
+      return;
+    }
+    const float dtExponent = deltaTime * m_TargetFramerate;
+    const float smooth = std::pow(m_SmoothStrength, dtExponent);
+    assert(smooth >= 0.0f && smooth <= 1.0f);
+    float weights[NUM_ITERATIONS];
+    weights[0] = std::pow(smooth, static_cast<float>(numSteps));
+    for (int m=1; m<NUM_ITERATIONS; m++) {
+      weights[m] = weights[m-1] * (1.0f-smooth) * static_cast<float>(numSteps+m-1) / static_cast<float>(m);
+    }
+    for (int i=NUM_ITERATIONS-1; i>=0; i--) {
+      // iterate downwards, so that the lower values are still the old ones
+      float goalWeight = 1.0f;
+      T value = weights[0]*m_Values[i];
+      goalWeight -= weights[0];
+      for (int j=0; j<i; j++) {
+        value = value + weights[i-j]*m_Values[j];
+        goalWeight -= weights[i-j];
+      }
+      m_Values[i] = value + goalWeight*m_Goal;
+    }
+  }
+
 private:
   T m_Values[NUM_ITERATIONS];
   T m_Goal;
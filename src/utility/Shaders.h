@@ -365,6 +365,73 @@ void main() {
   out_normal = (normal_matrix * vec4(normal, 0.0)).xyz;
   out_tex_coord = tex_coord;
 }
+)shader";
+
+  // As transformedVert, but the matrices are members of a uniform block, which ShaderFrontend
+  // fills from a uniform buffer (see UniformBufferRing) instead of with a glUniform call each.
+  static std::string transformedBlockVert = R"shader(
+#version 120
+#extension GL_ARB_uniform_buffer_object : require
+
+layout(std140) uniform ShaderMatrices {
+  mat4 projection_times_model_view_matrix;
+  mat4 model_view_matrix;
+  mat4 normal_matrix;
+};
+
+// attribute arrays
+attribute vec3 position;
+attribute vec3 normal;
+attribute vec2 tex_coord;
+
+// These are the inputs from the vertex shader to the fragment shader, and must appear identically there.
+varying vec3 out_position;
+varying vec3 out_normal;
+varying vec2 out_tex_coord;
+
+void main() {
+  gl_Position = projection_times_model_view_matrix * vec4(position, 1.0);
+  out_position = (model_view_matrix * vec4(position, 1.0)).xyz;
+  out_normal = (normal_matrix * vec4(normal, 0.0)).xyz;
+  out_tex_coord = tex_coord;
+}
+)shader";
+
+  // As transformedVert, but each vertex is first placed by per-instance attributes (see
+  // InstancedBatch): scaled by instance_scale, then transformed by instance_transform, which
+  // must be a rigid or uniformly scaled transform.  Normals are scaled by the inverse of
+  // instance_scale, which keeps them perpendicular to the surface.
+  static std::string instancedVert = R"shader(
+#version 120
+
+uniform mat4 projection_times_model_view_matrix;
+uniform mat4 model_view_matrix;
+
+// attribute arrays
+attribute vec3 position;
+attribute vec3 normal;
+attribute vec2 tex_coord;
+
+// per-instance attribute arrays
+attribute mat4 instance_transform;
+attribute vec3 instance_scale;
+attribute vec4 instance_color;
+
+// These are the inputs from the vertex shader to the fragment shader, and must appear identically there.
+varying vec3 out_position;
+varying vec3 out_normal;
+varying vec2 out_tex_coord;
+varying vec4 out_color;
+
+void main() {
+  vec4 instance_position = instance_transform * vec4(instance_scale * position, 1.0);
+  vec4 instance_normal = instance_transform * vec4(normal / instance_scale, 0.0);
+  gl_Position = projection_times_model_view_matrix * instance_position;
+  out_position = (model_view_matrix * instance_position).xyz;
+  out_normal = (model_view_matrix * instance_normal).xyz;
+  out_tex_coord = tex_coord;
+  out_color = instance_color;
+}
 )shader";
 
   static std::string materialFrag = R"shader(
@@ -401,6 +468,76 @@ void main() {
     gl_FragColor *= texture2D(texture, out_tex_coord);
   }
 }
+)shader";
+
+  // As materialFrag, but the material parameters are members of a uniform block (see
+  // transformedBlockVert).  Samplers can't be block members, so texture stays an ordinary uniform.
+  static std::string materialBlockFrag = R"shader(
+#version 120
+#extension GL_ARB_uniform_buffer_object : require
+
+// These are the inputs from the vertex shader to the fragment shader, and must appear identically there.
+varying vec3 out_position;
+varying vec3 out_normal;
+varying vec2 out_tex_coord;
+
+layout(std140) uniform LambertianMaterial {
+  vec3 light_position;                // The position of the (single) light for diffuse reflectance.  It is assumed to be white.
+  vec4 diffuse_light_color;           // The color for diffuse lighting.
+  vec4 ambient_light_color;           // The color for ambient lighting.
+  float ambient_lighting_proportion;  // See materialFrag.
+  bool use_texture;                   // True iff texture mapping is to be used.
+};
+uniform sampler2D texture;            // Defines the texture if texture mapping is to be used.
+
+void main() {
+  // Compute diffuse brightness: a value in [0,1] giving the proportion of reflected light from the light source.
+  vec3 surface_normal = normalize(out_normal);
+  vec3 light_dir = normalize(light_position - out_position);
+  float diffuse_brightness = max(0.0, dot(light_dir, surface_normal));
+
+  // Blend the ambient and diffuse lighting.
+  vec4 diffuse_color = diffuse_light_color;
+  diffuse_color.rgb = diffuse_brightness*diffuse_color.rgb;
+  gl_FragColor = ambient_lighting_proportion*ambient_light_color + (1.0-ambient_lighting_proportion)*diffuse_color;
+  // If texturing is enabled, include its influence in the color.
+  if (use_texture) {
+    // The fragment color is used as a color mask, hence the multiplication.
+    gl_FragColor *= texture2D(texture, out_tex_coord);
+  }
+}
+)shader";
+
+  // As materialFrag, but the ambient light color is multiplied by the per-instance color
+  // from instancedVert.
+  static std::string instancedMaterialFrag = R"shader(
+#version 120
+
+// These are the inputs from the vertex shader to the fragment shader, and must appear identically there.
+varying vec3 out_position;
+varying vec3 out_normal;
+varying vec2 out_tex_coord;
+varying vec4 out_color;
+
+uniform vec3 light_position;
+uniform vec4 diffuse_light_color;
+uniform vec4 ambient_light_color;
+uniform float ambient_lighting_proportion;
+uniform bool use_texture;
+uniform sampler2D texture;
+
+void main() {
+  vec3 surface_normal = normalize(out_normal);
+  vec3 light_dir = normalize(light_position - out_position);
+  float diffuse_brightness = max(0.0, dot(light_dir, surface_normal));
+
+  vec4 diffuse_color = diffuse_light_color;
+  diffuse_color.rgb = diffuse_brightness*diffuse_color.rgb;
+  gl_FragColor = ambient_lighting_proportion*ambient_light_color*out_color + (1.0-ambient_lighting_proportion)*diffuse_color;
+  if (use_texture) {
+    gl_FragColor *= texture2D(texture, out_tex_coord);
+  }
+}
 )shader";
 
 };
\ No newline at end of file
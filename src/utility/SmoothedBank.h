@@ -0,0 +1,272 @@
+#pragma once
+
+#include "EigenTypes.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Many Smoothed<> channels stored together and updated in one pass.
+//
+// Each channel is one lane (scalar) or three consecutive lanes (Vector3), and
+// every lane behaves exactly like a Smoothed<float, NUM_ITERATIONS>.  The lanes
+// are stored structure-of-arrays, one array per iteration, so the update is a
+// straight loop over contiguous floats that the compiler can vectorize.  std::pow
+// is evaluated once per distinct smooth strength rather than once per channel.
+//
+// A lane whose iterations are all within epsilon of its goal is snapped to the
+// goal and put to sleep; blocks of lanes which are all asleep are skipped
+// entirely.  Setting a new goal wakes the lane up again.
+template <int _NUM_ITERATIONS = 5>
+class SmoothedBank {
+public:
+
+  static const int NUM_ITERATIONS = _NUM_ITERATIONS;
+  typedef int Channel;
+
+  SmoothedBank(float targetFramerate = 100.0f, float epsilon = 1.0e-3f) :
+    m_TargetFramerate(targetFramerate),
+    m_Epsilon(epsilon),
+    m_NumLanes(0),
+    m_Capacity(0),
+    m_NumAwake(0)
+  { }
+
+  Channel AddScalar(float initialValue, float smoothStrength = 0.8f) {
+    const Channel channel = allocate(1, smoothStrength);
+    setImmediateLane(channel, initialValue);
+    return channel;
+  }
+
+  Channel AddVector3(const Eigen::Vector3d& initialValue, float smoothStrength = 0.8f) {
+    const Channel channel = allocate(3, smoothStrength);
+    for (int k = 0; k < 3; k++) {
+      setImmediateLane(channel + k, static_cast<float>(initialValue[k]));
+    }
+    return channel;
+  }
+
+  void Remove(Channel channel) {
+    const int width = m_Width[channel];
+    for (int k = 0; k < width; k++) {
+      setImmediateLane(channel + k, 0.0f);
+      releaseStrength(m_StrengthIdx[channel + k]);
+      m_StrengthIdx[channel + k] = NO_STRENGTH;
+    }
+    m_Width[channel] = 0;
+    m_FreeChannels[width == 3 ? 1 : 0].push_back(channel);
+  }
+
+  // scalar channels
+  float Value(Channel channel) const { return m_Values[(NUM_ITERATIONS-1)*m_Capacity + channel]; }
+  float Goal(Channel channel) const { return m_Goals[channel]; }
+  void SetGoal(Channel channel, float goal) { setGoalLane(channel, goal); }
+  void SetImmediate(Channel channel, float value) { setImmediateLane(channel, value); }
+
+  // Vector3 channels
+  Eigen::Vector3d Vector3Value(Channel channel) const {
+    const float* values = &m_Values[(NUM_ITERATIONS-1)*m_Capacity + channel];
+    return Eigen::Vector3d(values[0], values[1], values[2]);
+  }
+  Eigen::Vector3d Vector3Goal(Channel channel) const {
+    return Eigen::Vector3d(m_Goals[channel], m_Goals[channel + 1], m_Goals[channel + 2]);
+  }
+  void SetGoal(Channel channel, const Eigen::Vector3d& goal) {
+    for (int k = 0; k < 3; k++) {
+      setGoalLane(channel + k, static_cast<float>(goal[k]));
+    }
+  }
+  void SetImmediate(Channel channel, const Eigen::Vector3d& value) {
+    for (int k = 0; k < 3; k++) {
+      setImmediateLane(channel + k, static_cast<float>(value[k]));
+    }
+  }
+
+  void SetSmoothStrength(Channel channel, float smooth) {
+    for (int k = 0; k < m_Width[channel]; k++) {
+      const int lane = channel + k;
+      releaseStrength(m_StrengthIdx[lane]);
+      m_StrengthIdx[lane] = acquireStrength(smooth);
+    }
+  }
+
+  bool IsAsleep(Channel channel) const {
+    for (int k = 0; k < m_Width[channel]; k++) {
+      if (m_Awake[channel + k]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  int AwakeLaneCount() const { return m_NumAwake; }
+  int LaneCount() const { return m_NumLanes; }
+
+  // Advances every awake channel, equivalent to calling Smoothed::Update on each.
+  void Update(float deltaTime) {
+    if (m_NumAwake == 0) {
+      return;
+    }
+    const float dtExponent = deltaTime * m_TargetFramerate;
+    for (size_t i = 0; i < m_Strengths.size(); i++) {
+      m_StrengthSmooth[i] = m_StrengthRefs[i] > 0 ? std::pow(m_Strengths[i], dtExponent) : 1.0f;
+      assert(m_StrengthSmooth[i] >= 0.0f && m_StrengthSmooth[i] <= 1.0f);
+    }
+
+    const int numBlocks = (m_NumLanes + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    for (int b = 0; b < numBlocks; b++) {
+      if (m_BlockAwake[b] == 0) {
+        continue;
+      }
+      const int begin = b*BLOCK_SIZE;
+      float smooth[BLOCK_SIZE];
+      for (int l = 0; l < BLOCK_SIZE; l++) {
+        const uint16_t idx = m_StrengthIdx[begin + l];
+        smooth[l] = idx == NO_STRENGTH ? 1.0f : m_StrengthSmooth[idx];
+      }
+      for (int i = 0; i < NUM_ITERATIONS; i++) {
+        float* values = &m_Values[i*m_Capacity + begin];
+        const float* prev = i == 0 ? &m_Goals[begin] : &m_Values[(i-1)*m_Capacity + begin];
+        for (int l = 0; l < BLOCK_SIZE; l++) {
+          values[l] = smooth[l]*values[l] + (1.0f-smooth[l])*prev[l];
+        }
+      }
+      for (int l = 0; l < BLOCK_SIZE; l++) {
+        if (m_Awake[begin + l] && isConverged(begin + l)) {
+          setImmediateLane(begin + l, m_Goals[begin + l]);
+        }
+      }
+    }
+  }
+
+private:
+
+  static const int BLOCK_SIZE = 8;
+  static const uint16_t NO_STRENGTH = 0xFFFF;
+
+  Channel allocate(int width, float smoothStrength) {
+    std::vector<Channel>& freeList = m_FreeChannels[width == 3 ? 1 : 0];
+    Channel channel;
+    if (!freeList.empty()) {
+      channel = freeList.back();
+      freeList.pop_back();
+    } else {
+      channel = m_NumLanes;
+      if (m_NumLanes + width > m_Capacity) {
+        grow(m_NumLanes + width);
+      }
+      m_NumLanes += width;
+    }
+    m_Width[channel] = width;
+    for (int k = 0; k < width; k++) {
+      m_StrengthIdx[channel + k] = acquireStrength(smoothStrength);
+    }
+    return channel;
+  }
+
+  void grow(int minCapacity) {
+    int capacity = std::max(m_Capacity, BLOCK_SIZE);
+    while (capacity < minCapacity) {
+      capacity *= 2;
+    }
+    std::vector<float> values(NUM_ITERATIONS*capacity, 0.0f);
+    for (int i = 0; i < NUM_ITERATIONS; i++) {
+      std::copy(m_Values.begin() + i*m_Capacity, m_Values.begin() + (i+1)*m_Capacity, values.begin() + i*capacity);
+    }
+    m_Values.swap(values);
+    m_Goals.resize(capacity, 0.0f);
+    m_StrengthIdx.resize(capacity, NO_STRENGTH);
+    m_Awake.resize(capacity, 0);
+    m_Width.resize(capacity, 0);
+    m_BlockAwake.resize(capacity / BLOCK_SIZE, 0);
+    m_Capacity = capacity;
+  }
+
+  uint16_t acquireStrength(float smooth) {
+    size_t freeIdx = m_Strengths.size();
+    for (size_t i = 0; i < m_Strengths.size(); i++) {
+      if (m_StrengthRefs[i] > 0 && m_Strengths[i] == smooth) {
+        m_StrengthRefs[i]++;
+        return static_cast<uint16_t>(i);
+      }
+      if (m_StrengthRefs[i] == 0 && freeIdx == m_Strengths.size()) {
+        freeIdx = i;
+      }
+    }
+    if (freeIdx == m_Strengths.size()) {
+      assert(m_Strengths.size() < NO_STRENGTH);
+      m_Strengths.push_back(smooth);
+      m_StrengthRefs.push_back(0);
+      m_StrengthSmooth.push_back(1.0f);
+    }
+    m_Strengths[freeIdx] = smooth;
+    m_StrengthRefs[freeIdx] = 1;
+    return static_cast<uint16_t>(freeIdx);
+  }
+
+  void releaseStrength(uint16_t idx) {
+    if (idx != NO_STRENGTH) {
+      m_StrengthRefs[idx]--;
+    }
+  }
+
+  void setAwake(int lane, bool awake) {
+    if (m_Awake[lane] != static_cast<uint8_t>(awake)) {
+      m_Awake[lane] = awake;
+      const int delta = awake ? 1 : -1;
+      m_BlockAwake[lane / BLOCK_SIZE] += delta;
+      m_NumAwake += delta;
+    }
+  }
+
+  void setGoalLane(int lane, float goal) {
+    m_Goals[lane] = goal;
+    if (isConverged(lane)) {
+      setImmediateLane(lane, goal);
+    } else {
+      setAwake(lane, true);
+    }
+  }
+
+  void setImmediateLane(int lane, float value) {
+    m_Goals[lane] = value;
+    for (int i = 0; i < NUM_ITERATIONS; i++) {
+      m_Values[i*m_Capacity + lane] = value;
+    }
+    setAwake(lane, false);
+  }
+
+  bool isConverged(int lane) const {
+    const float goal = m_Goals[lane];
+    for (int i = 0; i < NUM_ITERATIONS; i++) {
+      if (std::fabs(m_Values[i*m_Capacity + lane] - goal) > m_Epsilon) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  float m_TargetFramerate;
+  float m_Epsilon;
+
+  int m_NumLanes;
+  int m_Capacity;
+  int m_NumAwake;
+
+  std::vector<float> m_Values;           // NUM_ITERATIONS arrays of m_Capacity lanes
+  std::vector<float> m_Goals;
+  std::vector<uint16_t> m_StrengthIdx;   // per lane, into the strength table
+  std::vector<uint8_t> m_Awake;
+  std::vector<int> m_Width;              // per channel (first lane), 0 if unused
+  std::vector<int> m_BlockAwake;         // number of awake lanes per block
+  std::vector<Channel> m_FreeChannels[2]; // scalar, Vector3
+
+  std::vector<float> m_Strengths;        // distinct smooth strengths in use
+  std::vector<int> m_StrengthRefs;
+  std::vector<float> m_StrengthSmooth;   // pow(strength, dtExponent) for the current update
+};
+
+template <int _NUM_ITERATIONS> const int SmoothedBank<_NUM_ITERATIONS>::NUM_ITERATIONS;
+template <int _NUM_ITERATIONS> const int SmoothedBank<_NUM_ITERATIONS>::BLOCK_SIZE;
+template <int _NUM_ITERATIONS> const uint16_t SmoothedBank<_NUM_ITERATIONS>::NO_STRENGTH;
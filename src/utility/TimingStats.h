@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Collects a series of durations (in seconds) and reports summary statistics.
+// Samples are kept so that percentiles are exact; a run of a few thousand
+// frames costs a few tens of kilobytes.
+class TimingStats {
+public:
+
+  TimingStats(const std::string& name = "") : m_Name(name), m_Total(0.0) { }
+
+  void AddSample(double seconds) {
+    m_Samples.push_back(seconds);
+    m_Total += seconds;
+  }
+
+  size_t Count() const { return m_Samples.size(); }
+  double Total() const { return m_Total; }
+  double Mean() const { return m_Samples.empty() ? 0.0 : m_Total / m_Samples.size(); }
+
+  double Min() const { return m_Samples.empty() ? 0.0 : *std::min_element(m_Samples.begin(), m_Samples.end()); }
+  double Max() const { return m_Samples.empty() ? 0.0 : *std::max_element(m_Samples.begin(), m_Samples.end()); }
+
+  // Nearest-rank percentile, with percent in [0, 100].
+  double Percentile(double percent) const {
+    if (m_Samples.empty()) {
+      return 0.0;
+    }
+    std::vector<double> sorted(m_Samples);
+    std::sort(sorted.begin(), sorted.end());
+    const double rank = std::ceil(std::min(std::max(percent, 0.0), 100.0) / 100.0 * sorted.size());
+    const size_t idx = static_cast<size_t>(std::max(rank, 1.0)) - 1;
+    return sorted[idx];
+  }
+
+  // Prints one line of milliseconds: name, count, mean, min, median, p95, p99, max.
+  void Print(std::ostream& stream) const {
+    stream << std::left << std::setw(12) << m_Name << std::right << std::fixed << std::setprecision(3)
+           << " n=" << Count()
+           << " mean=" << 1000.0*Mean()
+           << " min=" << 1000.0*Min()
+           << " p50=" << 1000.0*Percentile(50)
+           << " p95=" << 1000.0*Percentile(95)
+           << " p99=" << 1000.0*Percentile(99)
+           << " max=" << 1000.0*Max()
+           << " (ms)" << std::endl;
+  }
+
+private:
+
+  std::string m_Name;
+  std::vector<double> m_Samples;
+  double m_Total;
+};